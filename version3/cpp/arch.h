@@ -40,6 +40,7 @@ namespace amcl {
 /*** START OF USER CONFIGURABLE SECTION - set architecture ***/
 
 #define CHUNK @WL@		/**< size of chunk in bits = wordlength of computer = 16, 32 or 64. Note not all curve options are supported on 16-bit processors - see rom.c */
+//#define THREADS		/**< uncomment to use POSIX threads in ECP_muln_mt and ECP2_muln_mt. Programs must then be linked with -pthread */
 
 /*** END OF USER CONFIGURABLE SECTION ***/
 
@@ -93,6 +94,12 @@ namespace amcl {
 #define COMBA      /**< Use COMBA method for faster muls, sqrs and reductions */
 #endif
 
+#ifdef __GNUC__
+#define NOINLINE __attribute__((noinline))	/**< Keeps the stack frame of a function with large local tables out of its callers */
+#else
+#define NOINLINE
+#endif
+
 }
 
 #endif
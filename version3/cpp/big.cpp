@@ -536,16 +536,156 @@ void XXX::BIG_smul(BIG c,BIG a,BIG b)
 
 }
 
+#ifdef MULX_XXX
+
+/* x86-64 backend - non-negative BIGs are normalised and packed into full 64-bit words, multiplied and reduced using MULX/ADCX/ADOX, and unpacked again */
+/* Requires BMI2 and ADX instruction set extensions (Intel Broadwell, AMD Zen or later) */
+
+#include <immintrin.h>
+
+#define WLEN_XXX ((BASEBITS_XXX*(NLEN_XXX-1)+126)/64)   /**< Number of 64-bit words needed to hold a normalised BIG */
+#define WSHIFT_XXX (64*WLEN_XXX-BASEBITS_XXX*NLEN_XXX)  /**< Montgomery shift from 2^(BASEBITS*NLEN) to 2^(64*WLEN) */
+#define X64_TARGET __attribute__((target("bmi2,adx")))
+
+namespace XXX {
+	static void x64_pack(unsign64 *,int,chunk *,int,int);
+	static void x64_unpack(chunk *,int,unsign64 *,int);
+	X64_TARGET static unsign64 x64_addmul(unsign64 *,unsign64 *,unsign64,int);
+	X64_TARGET static void x64_mul(DBIG,BIG,BIG);
+	X64_TARGET static void x64_sqr(DBIG,BIG);
+	X64_TARGET static void x64_monty(BIG,BIG,chunk,DBIG);
+}
+
+/* pack n normalised digits of a, shifted left by sh bits, into nw words of w */
+static void XXX::x64_pack(unsign64 *w,int nw,chunk *a,int n,int sh)
+{
+    int i,k,s;
+    for (i=0; i<nw; i++) w[i]=0;
+    for (i=0; i<n; i++)
+    {
+        k=(i*BASEBITS_XXX+sh)/64;
+        s=(i*BASEBITS_XXX+sh)%64;
+        w[k]|=(unsign64)a[i]<<s;
+        if (s!=0 && k+1<nw) w[k+1]|=(unsign64)a[i]>>(64-s);
+    }
+}
+
+/* unpack nw words of w into n digits of a. Top digit takes all remaining bits */
+static void XXX::x64_unpack(chunk *a,int n,unsign64 *w,int nw)
+{
+    int i,k,s;
+    unsign64 t;
+    for (i=0; i<n; i++)
+    {
+        k=(i*BASEBITS_XXX)/64;
+        s=(i*BASEBITS_XXX)%64;
+        t=w[k]>>s;
+        if (s!=0 && k+1<nw) t|=w[k+1]<<(64-s);
+        if (i<n-1) t&=BMASK_XXX;
+        a[i]=(chunk)t;
+    }
+}
+
+/* r[0..n-1]+=a[0..n-1]*b, returns carry word. Two independent carry chains, one for each half of the partial products */
+X64_TARGET
+static unsign64 XXX::x64_addmul(unsign64 *r,unsign64 *a,unsign64 b,int n)
+{
+    int j;
+    unsigned char c1=0,c2=0;
+    unsign64 lo,hi,top=0;
+    unsigned long long t;
+    for (j=0; j<n; j++)
+    {
+        lo=_mulx_u64(a[j],b,(unsigned long long *)&hi);
+        c1=_addcarryx_u64(c1,r[j],lo,&t);
+        c2=_addcarryx_u64(c2,t,top,&t);
+        r[j]=t;
+        top=hi;
+    }
+    return top+c1+c2;
+}
+
+/* c=a*b */
+X64_TARGET
+static void XXX::x64_mul(DBIG c,BIG a,BIG b)
+{
+    int i;
+    BIG t;
+    unsign64 x[WLEN_XXX],y[WLEN_XXX],z[2*WLEN_XXX];
+    BIG_copy(t,a); BIG_norm(t);
+    x64_pack(x,WLEN_XXX,t,NLEN_XXX,0);
+    BIG_copy(t,b); BIG_norm(t);
+    x64_pack(y,WLEN_XXX,t,NLEN_XXX,0);
+    for (i=0; i<WLEN_XXX; i++) z[i]=0;
+    for (i=0; i<WLEN_XXX; i++)
+        z[WLEN_XXX+i]=x64_addmul(&z[i],x,y[i],WLEN_XXX);
+    x64_unpack(c,DNLEN_XXX,z,2*WLEN_XXX);
+}
+
+/* c=a*a - cross products once, doubled, plus squares */
+X64_TARGET
+static void XXX::x64_sqr(DBIG c,BIG a)
+{
+    int i;
+    unsigned char cy=0;
+    BIG b;
+    unsign64 x[WLEN_XXX],z[2*WLEN_XXX],lo,hi;
+    unsigned long long t;
+    BIG_copy(b,a); BIG_norm(b);
+    x64_pack(x,WLEN_XXX,b,NLEN_XXX,0);
+    for (i=0; i<2*WLEN_XXX; i++) z[i]=0;
+    for (i=0; i<WLEN_XXX-1; i++)
+        z[WLEN_XXX+i]=x64_addmul(&z[2*i+1],&x[i+1],x[i],WLEN_XXX-1-i);
+    for (i=2*WLEN_XXX-1; i>0; i--) z[i]=(z[i]<<1)|(z[i-1]>>63);
+    z[0]<<=1;
+    for (i=0; i<WLEN_XXX; i++)
+    {
+        lo=_mulx_u64(x[i],x[i],(unsigned long long *)&hi);
+        cy=_addcarryx_u64(cy,z[2*i],lo,&t); z[2*i]=t;
+        cy=_addcarryx_u64(cy,z[2*i+1],hi,&t); z[2*i+1]=t;
+    }
+    x64_unpack(c,DNLEN_XXX,z,2*WLEN_XXX);
+}
+
+/* a=d/2^(BASEBITS*NLEN) mod md. Word-by-word Montgomery reduction of d.2^WSHIFT */
+X64_TARGET
+static void XXX::x64_monty(BIG a,BIG md,chunk MC,DBIG d)
+{
+    int i;
+    unsigned char cy=0;
+    DBIG e;
+    unsign64 m[WLEN_XXX],z[2*WLEN_XXX],r[WLEN_XXX],q,minv;
+    unsigned long long t;
+    BIG_dcopy(e,d); BIG_dnorm(e);
+    x64_pack(m,WLEN_XXX,md,NLEN_XXX,0);
+    x64_pack(z,2*WLEN_XXX,e,DNLEN_XXX,WSHIFT_XXX);
+
+    minv=(unsign64)MC;           /* -1/md mod 2^BASEBITS, one Newton step gives -1/md mod 2^64 */
+    minv*=2+m[0]*minv;
+
+    for (i=0; i<WLEN_XXX; i++)
+    {   /* carry word from each row is saved in the now zero low word, and added in at the end */
+        q=z[i]*minv;
+        z[i]=x64_addmul(&z[i],m,q,WLEN_XXX);
+    }
+    for (i=0; i<WLEN_XXX; i++)
+    {
+        cy=_addcarryx_u64(cy,z[WLEN_XXX+i],z[i],&t);
+        r[i]=t;
+    }
+    x64_unpack(a,NLEN_XXX,r,WLEN_XXX);
+}
+
+#endif
+
 /* Set c=a*b */
 /* SU= 72 */
 void XXX::BIG_mul(DBIG c,BIG a,BIG b)
 {
-    int i;
 #ifdef dchunk
     dchunk t,co;
     dchunk s;
     dchunk d[NLEN_XXX];
-    int k;
 #endif
 
 #ifdef DEBUG_NORM
@@ -553,16 +693,22 @@ void XXX::BIG_mul(DBIG c,BIG a,BIG b)
 	if ((b[MPV_XXX]!=1 && b[MPV_XXX]!=0) || b[MNV_XXX]!=0) printf("Second input to mul not normed\n");
 #endif
 
+#ifdef MULX_XXX
+    x64_mul(c,a,b);
+#else
+
     /* Faster to Combafy it.. Let the compiler unroll the loops! */
 
 #ifdef COMBA
 
     /* faster psuedo-Karatsuba method */
-#ifdef UNWOUND
+#ifdef UNWOUND_XXX
 
-    /* Insert output of faster.c here */
+    /* Fully unrolled code generated by config script */
+@UMUL@
 
 #else
+    int i,k;
     for (i=0; i<NLEN_XXX; i++)
         d[i]=(dchunk)a[i]*b[i];
 
@@ -592,7 +738,7 @@ void XXX::BIG_mul(DBIG c,BIG a,BIG b)
 #endif
 
 #else
-    int j;
+    int i,j;
     chunk carry;
     BIG_dzero(c);
     for (i=0; i<NLEN_XXX; i++)
@@ -605,6 +751,7 @@ void XXX::BIG_mul(DBIG c,BIG a,BIG b)
     }
 
 #endif
+#endif
 
 #ifdef DEBUG_NORM
 	c[DMPV_XXX]=1;
@@ -616,7 +763,6 @@ void XXX::BIG_mul(DBIG c,BIG a,BIG b)
 /* SU= 80 */
 void XXX::BIG_sqr(DBIG c,BIG a)
 {
-    int i,j,last;
 #ifdef dchunk
     dchunk t,co;
 #endif
@@ -626,15 +772,20 @@ void XXX::BIG_sqr(DBIG c,BIG a)
 #endif
     /* Note 2*a[i] in loop below and extra addition */
 
+#ifdef MULX_XXX
+    x64_sqr(c,a);
+#else
+
 #ifdef COMBA
 
-#ifdef UNWOUND
+#ifdef UNWOUND_XXX
 
-    /* Insert output of faster.c here */
+    /* Fully unrolled code generated by config script */
+@USQR@
 
 #else
 
-
+    int i,j;
     t=(dchunk)a[0]*a[0]; 
     c[0]=(chunk)t&BMASK_XXX;
     co=t>>BASEBITS_XXX;
@@ -687,6 +838,7 @@ void XXX::BIG_sqr(DBIG c,BIG a)
 #endif
 
 #else
+    int i,j;
     chunk carry;
     BIG_dzero(c);
     for (i=0; i<NLEN_XXX; i++)
@@ -704,6 +856,7 @@ void XXX::BIG_sqr(DBIG c,BIG a)
 
     BIG_dnorm(c);
 #endif
+#endif
 
 
 #ifdef DEBUG_NORM
@@ -716,22 +869,26 @@ void XXX::BIG_sqr(DBIG c,BIG a)
 /* Montgomery reduction */
 void XXX::BIG_monty(BIG a,BIG md,chunk MC,DBIG d)
 {
-    int i,k;
-
 #ifdef dchunk
     dchunk t,c,s;
     dchunk dd[NLEN_XXX];
     chunk v[NLEN_XXX];
 #endif
 
+#ifdef MULX_XXX
+    x64_monty(a,md,MC,d);
+#else
+
 #ifdef COMBA
 
-#ifdef UNWOUND
+#ifdef UNWOUND_XXX
 
-    /* Insert output of faster.c here */
+    /* Fully unrolled code generated by config script */
+@UMON@
 
 #else
 
+    int i,k;
     t=d[0];
     v[0]=((chunk)t*MC)&BMASK_XXX;
     t+=(dchunk)v[0]*md[0];
@@ -763,7 +920,7 @@ void XXX::BIG_monty(BIG a,BIG md,chunk MC,DBIG d)
 
 
 #else
-    int j;
+    int i,j;
     chunk m,carry;
     for (i=0; i<NLEN_XXX; i++)
     {
@@ -782,6 +939,7 @@ void XXX::BIG_monty(BIG a,BIG md,chunk MC,DBIG d)
     BIG_norm(a);
 
 #endif
+#endif
 
 #ifdef DEBUG_NORM
 	a[MPV_XXX]=1;  a[MNV_XXX]=0;
@@ -1322,6 +1480,191 @@ void XXX::BIG_moddiv(BIG r,BIG a1,BIG b1,BIG m)
     BIG_dmod(r,d,m);
 }
 
+#ifdef dchunk
+
+/* Constant time modular inversion and Jacobi symbol using the Bernstein-Yang safegcd algorithm. See https://eprint.iacr.org/2019/266 */
+/* Signed values are held in SGLEN digits of BASEBITS bits, with the sign in the top digit */
+/* Divsteps are applied BASEBITS at a time using a 2x2 transition matrix, so dividing by 2^BASEBITS is a one digit shift */
+
+#define SGLEN_XXX (NLEN_XXX+1)
+
+namespace XXX {
+	static chunk sg_divsteps(chunk,chunk,chunk,chunk *);
+	static chunk sg_jacsteps(chunk,chunk,chunk,chunk *,chunk *);
+	static int sg_jacobi(BIG,BIG);
+	static void sg_update_fg(chunk *,chunk *,chunk *);
+	static void sg_update_de(chunk *,chunk *,chunk *,BIG,chunk);
+	static void sg_addmul(chunk *,BIG,chunk);
+}
+
+/* Apply BASEBITS divsteps to the low digits of f and g. Returns new delta */
+/* On exit t=[u,v,q,r] such that 2^BASEBITS.(f',g') = (u.f+v.g,q.f+r.g) */
+static chunk XXX::sg_divsteps(chunk delta,chunk f,chunk g,chunk *t)
+{
+    int i;
+    chunk u=1,v=0,q=0,r=1,c1,c2,x,y,z;
+    for (i=0; i<BASEBITS_XXX; i++)
+    {
+        c1=(-delta)>>(CHUNK-1);   // all ones if delta>0
+        c2=-(g&1);                // all ones if g is odd
+        x=(f^c1)-c1;
+        y=(u^c1)-c1;
+        z=(v^c1)-c1;
+        g+=x&c2;                  // g=g-f or g+f, if g is odd
+        q+=y&c2;
+        r+=z&c2;
+        c1&=c2;                   // swap if delta>0 and g is odd
+        delta=(delta^c1)-c1+1;
+        f+=g&c1;                  // f=g
+        u+=q&c1;
+        v+=r&c1;
+        g>>=1;
+        u+=u;
+        v+=v;
+    }
+    t[0]=u;
+    t[1]=v;
+    t[2]=q;
+    t[3]=r;
+    return delta;
+}
+
+/* Apply BASEBITS-3 posdivsteps to the low digits of f and g. f and g stay non-negative. Returns new delta */
+/* Bit 0 of jac is flipped for each change of sign of the Jacobi symbol (g/f) */
+/* On exit t=[u,v,q,r] such that 2^BASEBITS.(f',g') = (u.f+v.g,q.f+r.g) */
+static chunk XXX::sg_jacsteps(chunk delta,chunk f,chunk g,chunk *t,chunk *jac)
+{
+    int i;
+    chunk u=8,v=0,q=0,r=8,c1,c2,x,j=*jac;
+    for (i=0; i<BASEBITS_XXX-3; i++)
+    {
+        c1=(-delta)>>(CHUNK-1);   // all ones if delta>0
+        c2=-(g&1);                // all ones if g is odd
+        c1&=c2;                   // swap if delta>0 and g is odd
+        j^=c1&((f&g)>>1);         // quadratic reciprocity - flip if f=g=3 mod 4
+        x=(f^g)&c1; f^=x; g^=x;
+        x=(u^q)&c1; u^=x; q^=x;
+        x=(v^r)&c1; v^=x; r^=x;
+        delta=(delta^c1)-c1+1;
+        g+=f&c2;                  // g=g+f if g is odd
+        q+=u&c2;
+        r+=v&c2;
+        g>>=1;
+        j^=(f>>1)^(f>>2);         // (2/f)=-1 if f=3 or 5 mod 8
+        u+=u;
+        v+=v;
+    }
+    t[0]=u;
+    t[1]=v;
+    t[2]=q;
+    t[3]=r;
+    *jac=j;
+    return delta;
+}
+
+/* (f,g)=(u.f+v.g,q.f+r.g)/2^BASEBITS - exact division */
+static void XXX::sg_update_fg(chunk *f,chunk *g,chunk *t)
+{
+    int i;
+    dchunk cf,cg;
+    cf=(dchunk)t[0]*f[0]+(dchunk)t[1]*g[0];
+    cg=(dchunk)t[2]*f[0]+(dchunk)t[3]*g[0];
+    cf>>=BASEBITS_XXX;
+    cg>>=BASEBITS_XXX;
+    for (i=1; i<SGLEN_XXX; i++)
+    {
+        cf+=(dchunk)t[0]*f[i]+(dchunk)t[1]*g[i];
+        cg+=(dchunk)t[2]*f[i]+(dchunk)t[3]*g[i];
+        f[i-1]=(chunk)cf&BMASK_XXX;
+        g[i-1]=(chunk)cg&BMASK_XXX;
+        cf>>=BASEBITS_XXX;
+        cg>>=BASEBITS_XXX;
+    }
+    f[SGLEN_XXX-1]=(chunk)cf;
+    g[SGLEN_XXX-1]=(chunk)cg;
+}
+
+/* (d,e)=(u.d+v.e,q.d+r.e)/2^BASEBITS mod p, keeping -2p<d,e<p. pinv=1/p mod 2^BASEBITS */
+static void XXX::sg_update_de(chunk *d,chunk *e,chunk *t,BIG p,chunk pinv)
+{
+    int i;
+    chunk sd,se,md,me,pi;
+    dchunk cd,ce;
+    sd=d[SGLEN_XXX-1]>>(CHUNK-1);
+    se=e[SGLEN_XXX-1]>>(CHUNK-1);
+    md=(t[0]&sd)+(t[1]&se);     // add p.(u,q) if d<0 and p.(v,r) if e<0
+    me=(t[2]&sd)+(t[3]&se);
+    cd=(dchunk)t[0]*d[0]+(dchunk)t[1]*e[0];
+    ce=(dchunk)t[2]*d[0]+(dchunk)t[3]*e[0];
+    md-=(chunk)(((dchunk)pinv*((chunk)cd&BMASK_XXX)+md)&BMASK_XXX);   // so that bottom digit becomes zero
+    me-=(chunk)(((dchunk)pinv*((chunk)ce&BMASK_XXX)+me)&BMASK_XXX);
+    cd+=(dchunk)p[0]*md;
+    ce+=(dchunk)p[0]*me;
+    cd>>=BASEBITS_XXX;
+    ce>>=BASEBITS_XXX;
+    for (i=1; i<SGLEN_XXX; i++)
+    {
+        pi=0;
+        if (i<NLEN_XXX) pi=p[i];
+        cd+=(dchunk)t[0]*d[i]+(dchunk)t[1]*e[i]+(dchunk)pi*md;
+        ce+=(dchunk)t[2]*d[i]+(dchunk)t[3]*e[i]+(dchunk)pi*me;
+        d[i-1]=(chunk)cd&BMASK_XXX;
+        e[i-1]=(chunk)ce&BMASK_XXX;
+        cd>>=BASEBITS_XXX;
+        ce>>=BASEBITS_XXX;
+    }
+    d[SGLEN_XXX-1]=(chunk)cd;
+    e[SGLEN_XXX-1]=(chunk)ce;
+}
+
+/* d+=m.p, m a small signed integer */
+static void XXX::sg_addmul(chunk *d,BIG p,chunk m)
+{
+    int i;
+    chunk pi;
+    dchunk c=0;
+    for (i=0; i<SGLEN_XXX-1; i++)
+    {
+        pi=0;
+        if (i<NLEN_XXX) pi=p[i];
+        c+=(dchunk)d[i]+(dchunk)m*pi;
+        d[i]=(chunk)c&BMASK_XXX;
+        c>>=BASEBITS_XXX;
+    }
+    d[SGLEN_XXX-1]+=(chunk)c;
+}
+
+/* Jacobi symbol (a/p) for 0<=a<p, p odd, by posdivsteps. Once f=1 the symbol is known. Not constant time */
+/* Returns 2 if f has not reached 1 after 4.nbits(p) steps, which is always the case if gcd(a,p)>1 */
+static int XXX::sg_jacobi(BIG a,BIG p)
+{
+    int i,k,n;
+    chunk delta,jac=0,t[4],z;
+    chunk f[SGLEN_XXX],g[SGLEN_XXX];
+
+    for (i=0; i<NLEN_XXX; i++)
+    {
+        f[i]=p[i];
+        g[i]=a[i];
+    }
+    f[NLEN_XXX]=g[NLEN_XXX]=0;
+
+    n=4*BIG_nbits(p);
+    delta=1;
+    for (k=0; k<n; k+=BASEBITS_XXX-3)
+    {
+        delta=sg_jacsteps(delta,f[0],g[0],t,&jac);
+        sg_update_fg(f,g,t);
+
+        z=f[0]^1;
+        for (i=1; i<SGLEN_XXX; i++) z|=f[i];
+        if (z==0) return 1-2*(int)(jac&1);
+    }
+    return 2;
+}
+
+#endif
+
 /* Get jacobi Symbol (a/p). Returns 0, 1 or -1 */
 /* SU= 216 */
 int XXX::BIG_jacobi(BIG a,BIG p)
@@ -1336,6 +1679,11 @@ int XXX::BIG_jacobi(BIG a,BIG p)
     BIG_copy(n,p);
     BIG_mod(x,p);
 
+#ifdef dchunk
+    k=sg_jacobi(x,n);
+    if (k!=2) return k;
+#endif
+
     while (BIG_comp(n,one)>0)
     {
         if (BIG_comp(x,zilch)==0) return 0;
@@ -1360,6 +1708,66 @@ int XXX::BIG_jacobi(BIG a,BIG p)
     else return -1;
 }
 
+#ifdef dchunk
+
+/* Set r=1/a mod p, p odd. Constant time safegcd method */
+void XXX::BIG_invmodp(BIG r,BIG a,BIG p)
+{
+    int i,n,nb;
+    chunk delta,s,pinv,t[4];
+    chunk f[SGLEN_XXX],g[SGLEN_XXX],d[SGLEN_XXX],e[SGLEN_XXX],w[SGLEN_XXX];
+    unsign64 x,y;
+
+    BIG_mod(a,p);
+    for (i=0; i<NLEN_XXX; i++)
+    {
+        f[i]=p[i];
+        g[i]=a[i];
+        d[i]=0;
+        e[i]=0;
+    }
+    f[NLEN_XXX]=g[NLEN_XXX]=d[NLEN_XXX]=e[NLEN_XXX]=0;
+    e[0]=1;
+
+// pinv=1/p mod 2^BASEBITS by Newton iteration, each step doubles the number of correct bits
+    x=(unsign64)p[0];
+    y=x;
+    for (i=0; i<5; i++) y*=2-x*y;
+    pinv=(chunk)(y&BMASK_XXX);
+
+// Number of divsteps guaranteed to reach g=0 - depends only on the size of the modulus
+    nb=BIG_nbits(p);
+    if (nb<46) n=(49*nb+80)/17;
+    else n=(49*nb+57)/17;
+
+    delta=1;
+    for (i=0; i<n; i+=BASEBITS_XXX)
+    {
+        delta=sg_divsteps(delta,f[0],g[0],t);
+        sg_update_de(d,e,t,p,pinv);
+        sg_update_fg(f,g,t);
+    }
+
+// Now f=+/-1, and 1/a = f.d with -2p<d<p
+    s=f[SGLEN_XXX-1]>>(CHUNK-1);
+    for (i=0; i<SGLEN_XXX; i++) d[i]=(d[i]^s)-s;
+    sg_addmul(d,p,2);                  // 0<d<4p
+
+    for (i=0; i<SGLEN_XXX; i++) w[i]=d[i];
+    sg_addmul(w,p,-2);
+    s=w[SGLEN_XXX-1]>>(CHUNK-1);     // keep d if d-2p<0
+    for (i=0; i<SGLEN_XXX; i++) d[i]^=(d[i]^w[i])&~s;
+
+    for (i=0; i<SGLEN_XXX; i++) w[i]=d[i];
+    sg_addmul(w,p,-1);
+    s=w[SGLEN_XXX-1]>>(CHUNK-1);
+    for (i=0; i<SGLEN_XXX; i++) d[i]^=(d[i]^w[i])&~s;
+
+    for (i=0; i<NLEN_XXX; i++) r[i]=d[i];
+}
+
+#else
+
 /* Set r=1/a mod p. Binary method */
 /* SU= 240 */
 void XXX::BIG_invmodp(BIG r,BIG a,BIG p)
@@ -1425,6 +1833,8 @@ void XXX::BIG_invmodp(BIG r,BIG a,BIG p)
         BIG_copy(r,x2);
 }
 
+#endif
+
 /* set x = x mod 2^m */
 void XXX::BIG_mod2m(BIG x,int m)
 {
@@ -11,7 +11,8 @@
 using namespace amcl;
 
 
-//#define UNWOUND
+//#define UNWOUND_XXX  /**< Fully unrolled BIG_mul, BIG_sqr and BIG_monty - set by config script if faster */
+//#define MULX_XXX  /**< x86-64 MULX/ADX backend for BIG_mul, BIG_sqr and BIG_monty - set by config script */
 
 #define BIGBITS_XXX (8*MODBYTES_XXX)
 #define NLEN_XXX (1+((8*MODBYTES_XXX-1)/BASEBITS_XXX))
@@ -523,7 +524,7 @@ extern void BIG_modneg(BIG x,BIG y,BIG n);
 extern int BIG_jacobi(BIG x,BIG y);
 /**	@brief  Calculate x=1/y mod n
  *
-	Modular Inversion - This is slow. Uses binary method.
+	Modular Inversion - constant time safegcd method, or binary method if no double length type is available. n must be odd
 	@param x BIG number, on exit = 1/y mod n
 	@param y BIG number
 	@param n The BIG Modulus
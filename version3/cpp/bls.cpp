@@ -43,6 +43,103 @@ static void BLS_HASHIT(ECP *P,char *m)
 	ECP_mapit(P,&HM);
 }
 
+/* precompute the line functions of the fixed G2 generator */
+
+static int BLS_GENLINES(PAIR_precomp *T)
+{
+	ECP2 G;
+	ECP2_generator(&G);
+	PAIR_precomp_init(T,&G);
+	return 1;
+}
+
+/* the generator lines, built on first use - static initialisation is thread safe */
+
+static PAIR_precomp *BLS_GENERATOR_LINES()
+{
+	static PAIR_precomp GL;
+	static const int gl=BLS_GENLINES(&GL);
+	(void)gl;
+	return &GL;
+}
+
+/* random non-zero 64-bit multiplier */
+
+static void BLS_RANDOM64(BIG r,csprng *RNG)
+{
+	int i;
+	BIG_zero(r);
+	for (i=0; i<8; i++)
+	{
+		BIG_fshl(r,8);
+		BIG_inc(r,RAND_byte(RNG));
+		BIG_norm(r);
+	}
+	if (BIG_iszilch(r)) BIG_one(r);
+}
+
+/* Decode a signature. Returns 0 if it is not a point on the curve, or is the point at infinity */
+
+static int BLS_GET_SIG(ECP *D,octet *SIG)
+{
+	if (!ECP_fromOctet(D,SIG)) return 0;
+	return !ECP_isinf(D);
+}
+
+/* Decode a public key. Returns 0 if it is not a point on the curve, or is the point at infinity */
+
+static int BLS_GET_PK(ECP2 *PK,octet *W)
+{
+	if (!ECP2_fromOctet(PK,W)) return 0;
+	return !ECP2_isinf(PK);
+}
+
+/* Check e(-(r_0.D_0+..+r_{n-1}.D_{n-1}),G).e(r_0.HM_0,PK_0)...e(r_{n-1}.HM_{n-1},PK_{n-1})=1 for random r_i */
+/* A bad signature survives the random multipliers with probability 2^-64 */
+
+static int BLS_BATCH_CHECK(ECP *D,ECP *HM,ECP2 *PK,int n,csprng *RNG)
+{
+	int i;
+	BIG r[BLS_BATCH_ZZZ];
+	ECP S,R[BLS_BATCH_ZZZ];
+	FP12 v;
+
+	for (i=0; i<n; i++)
+	{
+		BLS_RANDOM64(r[i],RNG);
+		ECP_copy(&R[i],&HM[i]);
+		ECP_mul_proj(&R[i],r[i]);
+	}
+	ECP_muln(&S,D,r,n);
+	ECP_neg(&S);
+
+	PAIR_ate_multi_precomp(&v,BLS_GENERATOR_LINES(),&S,PK,R,n);
+	PAIR_fexp(&v);
+	return FP12_isunity(&v);
+}
+
+/* Set res[i] for signatures 0..n-1, bisecting until the bad ones are found. If bad is set the range is already known to fail */
+/* Returns the number of bad signatures */
+
+static int BLS_BATCH_FIND(int *res,ECP *D,ECP *HM,ECP2 *PK,int n,int bad,csprng *RNG)
+{
+	int i,h,f;
+	if (!bad && BLS_BATCH_CHECK(D,HM,PK,n,RNG))
+	{
+		for (i=0; i<n; i++) res[i]=BLS_OK;
+		return 0;
+	}
+	if (n==1)
+	{
+		res[0]=BLS_FAIL;
+		return 1;
+	}
+	h=n/2;
+	f=BLS_BATCH_FIND(res,D,HM,PK,h,0,RNG);
+	/* if the first half is good, the second half must be bad */
+	return f+BLS_BATCH_FIND(&res[h],&D[h],&HM[h],&PK[h],n-h,(f==0),RNG);
+}
+
 /* generate key pair, private key S, public key W */
 
 int ZZZ::BLS_KEY_PAIR_GENERATE(csprng *RNG,octet* S,octet *W)
@@ -50,11 +147,10 @@ int ZZZ::BLS_KEY_PAIR_GENERATE(csprng *RNG,octet* S,octet *W)
 	ECP2 G;
 	BIG s,q;
     BIG_rcopy(q,CURVE_Order);
-	ECP2_generator(&G);
 	BIG_randomnum(s,q,RNG);
     BIG_toBytes(S->val,s);
     S->len=MODBYTES_XXX;
-    PAIR_G2mul(&G,s);
+    ECP2_mul_gen(&G,s);
 	ECP2_toOctet(W,&G);
 	return BLS_OK;
 }
@@ -67,36 +163,213 @@ int ZZZ::BLS_SIGN(octet *SIG,char *m,octet *S)
 	ECP D;
 	BLS_HASHIT(&D,m);
 	BIG_fromBytes(s,S->val);
-	PAIR_G1mul(&D,s);
+	PAIR_G1mul_proj(&D,s);
 	ECP_toOctet(SIG,&D,true); /* compress output */
 	return BLS_OK;
 }
 
-/* Verify signature given message m, the signature SIG, and the public key W */
-int ZZZ::BLS_VERIFY(octet *SIG,char *m,octet *W)
+/* Check signature SIG of message m against public key PK */
+
+static int BLS_CHECK(octet *SIG,char *m,ECP2 *PK)
 {
 	FP12 v;
-	ECP2 G,PK;
 	ECP D,HM;
+	if (!BLS_GET_SIG(&D,SIG)) return BLS_FAIL;
 	BLS_HASHIT(&HM,m);
-	ECP_fromOctet(&D,SIG);
-	ECP2_generator(&G);
-	ECP2_fromOctet(&PK,W);
 	ECP_neg(&D);
 
-// Use new multi-pairing mechanism 
+// Use shared Miller loop, with the precomputed lines of the generator
 
-	FP12 r[ATE_BITS_ZZZ];
-	PAIR_initmp(r);
-	PAIR_another(r,&G,&D);
-	PAIR_another(r,&PK,&HM);
-	PAIR_miller(&v,r);
+	PAIR_ate_multi_precomp(&v,BLS_GENERATOR_LINES(),&D,PK,&HM,1);
 
 //.. or alternatively
-//    PAIR_double_ate(&v,&G,&D,&PK,&HM);
+//    PAIR_double_ate(&v,&G,&D,PK,&HM);
 
 	PAIR_fexp(&v);
     if (FP12_isunity(&v)) return BLS_OK;
 	return BLS_FAIL;
 }
 
+/* Sum of the n public keys in W. Returns 0 if any is not a point on the curve, or is infinity */
+
+static int BLS_ADD_PKS(ECP2 *PK,octet *W,int n)
+{
+	int i,valid=1;
+	ECP2 P;
+	ECP2_inf(PK);
+	for (i=0; i<n; i++)
+	{
+		if (!BLS_GET_PK(&P,&W[i])) valid=0;
+		ECP2_add(PK,&P);
+	}
+	return valid;
+}
+
+/* Verify signature given message m, the signature SIG, and the public key W */
+int ZZZ::BLS_VERIFY(octet *SIG,char *m,octet *W)
+{
+	ECP2 PK;
+	if (!BLS_GET_PK(&PK,W)) return BLS_FAIL;
+	return BLS_CHECK(SIG,m,&PK);
+}
+
+/* Aggregate n signatures SIG[i] into one signature AS */
+
+int ZZZ::BLS_AGGREGATE_SIG(octet *AS,octet *SIG,int n)
+{
+	int i;
+	ECP S,D;
+	if (n<1) return BLS_FAIL;
+	ECP_inf(&S);
+	for (i=0; i<n; i++)
+	{
+		if (!BLS_GET_SIG(&D,&SIG[i])) return BLS_FAIL;
+		ECP_add(&S,&D);
+	}
+	ECP_toOctet(AS,&S,true); /* compress output */
+	return BLS_OK;
+}
+
+/* Aggregate n public keys W[i] into one public key AW */
+
+int ZZZ::BLS_AGGREGATE_PK(octet *AW,octet *W,int n)
+{
+	ECP2 PK;
+	if (n<1 || !BLS_ADD_PKS(&PK,W,n)) return BLS_FAIL;
+	ECP2_toOctet(AW,&PK);
+	return BLS_OK;
+}
+
+/* Verify aggregate signature AS of the same message m by n public keys W[i] */
+
+int ZZZ::BLS_FAST_AGGREGATE_VERIFY(octet *AS,char *m,octet *W,int n)
+{
+	ECP2 PK;
+	if (n<1 || !BLS_ADD_PKS(&PK,W,n)) return BLS_FAIL;
+	return BLS_CHECK(AS,m,&PK);
+}
+
+#define BLS_DISTINCT_SORT 16 /* more messages than this are sorted to find repeats, rather than compared in pairs */
+
+/* Swap messages i and j, and their public keys */
+
+static void BLS_SWAP(char **m,octet *W,int i,int j)
+{
+	char *t=m[i];
+	octet o=W[i];
+	m[i]=m[j]; m[j]=t;
+	W[i]=W[j]; W[j]=o;
+}
+
+/* Sift message i down the heap of the first n messages */
+
+static void BLS_SIFT(char **m,octet *W,int i,int n)
+{
+	int j;
+	while ((j=2*i+1)<n)
+	{
+		if (j+1<n && strcmp(m[j+1],m[j])>0) j++;
+		if (strcmp(m[i],m[j])>=0) return;
+		BLS_SWAP(m,W,i,j);
+		i=j;
+	}
+}
+
+/* Returns 1 if the n messages are all different */
+/* Large n are heap sorted in place, each public key moving with its message, so repeats are neighbours */
+
+static int BLS_DISTINCT(char **m,octet *W,int n)
+{
+	int i,j;
+	if (n<=BLS_DISTINCT_SORT)
+	{
+		for (i=1; i<n; i++)
+			for (j=0; j<i; j++)
+				if (strcmp(m[i],m[j])==0) return 0;
+		return 1;
+	}
+	for (i=n/2-1; i>=0; i--)
+		BLS_SIFT(m,W,i,n);
+	for (i=n-1; i>0; i--)
+	{
+		BLS_SWAP(m,W,0,i);
+		BLS_SIFT(m,W,0,i);
+	}
+	for (i=1; i<n; i++)
+		if (strcmp(m[i-1],m[i])==0) return 0;
+	return 1;
+}
+
+/* Verify aggregate signature AS of messages m[i] by public keys W[i], as one (n+1)-pairing */
+
+int ZZZ::BLS_AGGREGATE_VERIFY(octet *AS,char **m,octet *W,int n)
+{
+	int i,j,k;
+	FP12 v,t;
+	ECP2 PK[PAIR_MULTI_MAX_ZZZ];
+	ECP D,HM[PAIR_MULTI_MAX_ZZZ];
+
+	if (n<1 || !BLS_DISTINCT(m,W,n) || !BLS_GET_SIG(&D,AS)) return BLS_FAIL;
+	ECP_neg(&D);
+
+	for (j=0; j<n; j+=PAIR_MULTI_MAX_ZZZ)
+	{
+		k=n-j;
+		if (k>PAIR_MULTI_MAX_ZZZ) k=PAIR_MULTI_MAX_ZZZ;
+		for (i=0; i<k; i++)
+		{
+			if (!BLS_GET_PK(&PK[i],&W[j+i])) return BLS_FAIL;
+			BLS_HASHIT(&HM[i],m[j+i]);
+		}
+		if (j==0)
+			PAIR_ate_multi_precomp(&v,BLS_GENERATOR_LINES(),&D,PK,HM,k);
+		else
+		{
+			PAIR_ate_multi(&t,PK,HM,k);
+			FP12_mul(&v,&t);
+		}
+	}
+
+	PAIR_fexp(&v);
+    if (FP12_isunity(&v)) return BLS_OK;
+	return BLS_FAIL;
+}
+
+/* Verify n signatures SIG[i] of messages m[i] under public keys W[i] together, setting res[i] to BLS_OK or BLS_FAIL */
+
+int ZZZ::BLS_VERIFY_BATCH(csprng *RNG,int *res,octet *SIG,char **m,octet *W,int n)
+{
+	int i,j,k,c,f=0;
+	int ix[BLS_BATCH_ZZZ],r[BLS_BATCH_ZZZ];
+	ECP2 PK[BLS_BATCH_ZZZ];
+	ECP D[BLS_BATCH_ZZZ],HM[BLS_BATCH_ZZZ];
+
+	if (n<1) return BLS_FAIL;
+	for (j=0; j<n; j+=BLS_BATCH_ZZZ)
+	{
+		k=n-j;
+		if (k>BLS_BATCH_ZZZ) k=BLS_BATCH_ZZZ;
+
+		/* signatures or keys which do not decode fail at once, and are left out of the batch */
+		c=0;
+		for (i=0; i<k; i++)
+		{
+			if (BLS_GET_SIG(&D[c],&SIG[j+i]) && BLS_GET_PK(&PK[c],&W[j+i]))
+			{
+				BLS_HASHIT(&HM[c],m[j+i]);
+				ix[c++]=j+i;
+			}
+			else
+			{
+				res[j+i]=BLS_FAIL;
+				f++;
+			}
+		}
+		if (c==0) continue;
+		f+=BLS_BATCH_FIND(r,D,HM,PK,c,0,RNG);
+		for (i=0; i<c; i++)
+			res[ix[i]]=r[i];
+	}
+	if (f==0) return BLS_OK;
+	return BLS_FAIL;
+}
@@ -50,11 +50,10 @@ int ZZZ::BLS_KEY_PAIR_GENERATE(csprng *RNG,octet* S,octet *W)
 	ECP4 G;
 	BIG s,q;
     BIG_rcopy(q,CURVE_Order);
-	ECP4_generator(&G);
 	BIG_randomnum(s,q,RNG);
     BIG_toBytes(S->val,s);
     S->len=MODBYTES_XXX;
-    PAIR_G2mul(&G,s);
+    ECP4_mul_gen(&G,s);
 	ECP4_toOctet(W,&G);
 	return BLS_OK;
 }
@@ -72,31 +71,187 @@ int ZZZ::BLS_SIGN(octet *SIG,char *m,octet *S)
 	return BLS_OK;
 }
 
-/* Verify signature given message m, the signature SIG, and the public key W */
-int ZZZ::BLS_VERIFY(octet *SIG,char *m,octet *W)
+/* Decode a signature. Returns 0 if it is not a point on the curve, or is the point at infinity */
+
+static int BLS_GET_SIG(ECP *D,octet *SIG)
+{
+	if (!ECP_fromOctet(D,SIG)) return 0;
+	return !ECP_isinf(D);
+}
+
+/* Decode a public key. Returns 0 if it is not a point on the curve, or is the point at infinity */
+
+static int BLS_GET_PK(ECP4 *PK,octet *W)
+{
+	if (!ECP4_fromOctet(PK,W)) return 0;
+	return !ECP4_isinf(PK);
+}
+
+/* Check signature SIG of message m against public key PK */
+
+static int BLS_CHECK(octet *SIG,char *m,ECP4 *PK)
 {
 	FP24 v;
-	ECP4 G,PK;
-	ECP D,HM;
-	BLS_HASHIT(&HM,m);
-	ECP_fromOctet(&D,SIG);
-	ECP4_generator(&G);
-	ECP4_fromOctet(&PK,W);
-	ECP_neg(&D);
-
-// Use new multi-pairing mechanism 
-
-	FP24 r[ATE_BITS_ZZZ];
-	PAIR_initmp(r);
-	PAIR_another(r,&G,&D);
-	PAIR_another(r,&PK,&HM);
-	PAIR_miller(&v,r);
+	ECP4 P[2];
+	ECP Q[2];
+	if (!BLS_GET_SIG(&Q[0],SIG)) return BLS_FAIL;
+	BLS_HASHIT(&Q[1],m);
+	ECP4_generator(&P[0]);
+	ECP4_copy(&P[1],PK);
+	ECP_neg(&Q[0]);
+
+// Use shared Miller loop
+
+	PAIR_ate_multi(&v,P,Q,2);
 
 //.. or alternatively
-//    PAIR_double_ate(&v,&G,&D,&PK,&HM);
+//    PAIR_double_ate(&v,&P[0],&Q[0],&P[1],&Q[1]);
 
     PAIR_fexp(&v);
     if (FP24_isunity(&v)) return BLS_OK;
 	return BLS_FAIL;
 }
 
+/* Sum of the n public keys in W. Returns 0 if any is not a point on the curve, or is infinity */
+
+static int BLS_ADD_PKS(ECP4 *PK,octet *W,int n)
+{
+	int i,valid=1;
+	ECP4 P;
+	ECP4_inf(PK);
+	for (i=0; i<n; i++)
+	{
+		if (!BLS_GET_PK(&P,&W[i])) valid=0;
+		ECP4_add(PK,&P);
+	}
+	return valid;
+}
+
+/* Verify signature given message m, the signature SIG, and the public key W */
+int ZZZ::BLS_VERIFY(octet *SIG,char *m,octet *W)
+{
+	ECP4 PK;
+	if (!BLS_GET_PK(&PK,W)) return BLS_FAIL;
+	return BLS_CHECK(SIG,m,&PK);
+}
+
+/* Aggregate n signatures SIG[i] into one signature AS */
+
+int ZZZ::BLS_AGGREGATE_SIG(octet *AS,octet *SIG,int n)
+{
+	int i;
+	ECP S,D;
+	if (n<1) return BLS_FAIL;
+	ECP_inf(&S);
+	for (i=0; i<n; i++)
+	{
+		if (!BLS_GET_SIG(&D,&SIG[i])) return BLS_FAIL;
+		ECP_add(&S,&D);
+	}
+	ECP_toOctet(AS,&S,true); /* compress output */
+	return BLS_OK;
+}
+
+/* Aggregate n public keys W[i] into one public key AW */
+
+int ZZZ::BLS_AGGREGATE_PK(octet *AW,octet *W,int n)
+{
+	ECP4 PK;
+	if (n<1 || !BLS_ADD_PKS(&PK,W,n)) return BLS_FAIL;
+	ECP4_toOctet(AW,&PK);
+	return BLS_OK;
+}
+
+/* Verify aggregate signature AS of the same message m by n public keys W[i] */
+
+int ZZZ::BLS_FAST_AGGREGATE_VERIFY(octet *AS,char *m,octet *W,int n)
+{
+	ECP4 PK;
+	if (n<1 || !BLS_ADD_PKS(&PK,W,n)) return BLS_FAIL;
+	return BLS_CHECK(AS,m,&PK);
+}
+
+#define BLS_DISTINCT_SORT 16 /* more messages than this are sorted to find repeats, rather than compared in pairs */
+
+/* Swap messages i and j, and their public keys */
+
+static void BLS_SWAP(char **m,octet *W,int i,int j)
+{
+	char *t=m[i];
+	octet o=W[i];
+	m[i]=m[j]; m[j]=t;
+	W[i]=W[j]; W[j]=o;
+}
+
+/* Sift message i down the heap of the first n messages */
+
+static void BLS_SIFT(char **m,octet *W,int i,int n)
+{
+	int j;
+	while ((j=2*i+1)<n)
+	{
+		if (j+1<n && strcmp(m[j+1],m[j])>0) j++;
+		if (strcmp(m[i],m[j])>=0) return;
+		BLS_SWAP(m,W,i,j);
+		i=j;
+	}
+}
+
+/* Returns 1 if the n messages are all different */
+/* Large n are heap sorted in place, each public key moving with its message, so repeats are neighbours */
+
+static int BLS_DISTINCT(char **m,octet *W,int n)
+{
+	int i,j;
+	if (n<=BLS_DISTINCT_SORT)
+	{
+		for (i=1; i<n; i++)
+			for (j=0; j<i; j++)
+				if (strcmp(m[i],m[j])==0) return 0;
+		return 1;
+	}
+	for (i=n/2-1; i>=0; i--)
+		BLS_SIFT(m,W,i,n);
+	for (i=n-1; i>0; i--)
+	{
+		BLS_SWAP(m,W,0,i);
+		BLS_SIFT(m,W,0,i);
+	}
+	for (i=1; i<n; i++)
+		if (strcmp(m[i-1],m[i])==0) return 0;
+	return 1;
+}
+
+/* Verify aggregate signature AS of messages m[i] by public keys W[i], as one (n+1)-pairing */
+/* The generator and the first PAIR_MULTI_MAX-1 public keys share the first Miller loop */
+
+int ZZZ::BLS_AGGREGATE_VERIFY(octet *AS,char **m,octet *W,int n)
+{
+	int j,k;
+	FP24 v,t;
+	ECP4 P[PAIR_MULTI_MAX_ZZZ];
+	ECP Q[PAIR_MULTI_MAX_ZZZ];
+
+	if (n<1 || !BLS_DISTINCT(m,W,n) || !BLS_GET_SIG(&Q[0],AS)) return BLS_FAIL;
+	ECP4_generator(&P[0]);
+	ECP_neg(&Q[0]);
+	FP24_one(&v);
+
+	k=1;
+	for (j=0; j<n; j++)
+	{
+		if (!BLS_GET_PK(&P[k],&W[j])) return BLS_FAIL;
+		BLS_HASHIT(&Q[k],m[j]);
+		k++;
+		if (k==PAIR_MULTI_MAX_ZZZ || j==n-1)
+		{
+			PAIR_ate_multi(&t,P,Q,k);
+			FP24_mul(&v,&t);
+			k=0;
+		}
+	}
+
+	PAIR_fexp(&v);
+    if (FP24_isunity(&v)) return BLS_OK;
+	return BLS_FAIL;
+}
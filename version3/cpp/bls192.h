@@ -71,9 +71,47 @@ int BLS_SIGN(octet *SIG,char *m,octet *S);
 	@param SIG an input signature
 	@param m is the message whose signature is to be verified.
 	@param W an public key
-	@return BLS_OK if verified, otherwise BLS_FAIL
+	@return BLS_OK if verified, otherwise BLS_FAIL. Fails if SIG or W is not a valid point, or is infinity
  */
 int BLS_VERIFY(octet *SIG,char *m,octet *W);
+/**	@brief Aggregate signatures
+ *
+	The aggregate of signatures of the same or different messages can be checked with BLS_FAST_AGGREGATE_VERIFY or BLS_AGGREGATE_VERIFY
+	@param AS the output aggregate signature
+	@param SIG array of n input signatures
+	@param n number of signatures
+	@return BLS_OK, or BLS_FAIL if n<1 or any signature is not a point on the curve, or is infinity
+ */
+int BLS_AGGREGATE_SIG(octet *AS,octet *SIG,int n);
+/**	@brief Aggregate public keys
+ *
+	@param AW the output aggregate public key, which verifies aggregate signatures of the same message with BLS_VERIFY
+	@param W array of n input public keys
+	@param n number of public keys
+	@return BLS_OK, or BLS_FAIL if n<1 or any public key is not a point on the curve, or is infinity
+ */
+int BLS_AGGREGATE_PK(octet *AW,octet *W,int n);
+/**	@brief Verify an aggregate signature of one message by many signers
+ *
+	The public keys are added, so this costs the same as BLS_VERIFY. To resist rogue key attacks the keys must come with proofs of possession
+	@param AS an input aggregate signature
+	@param m is the message signed by all signers
+	@param W array of n public keys
+	@param n number of public keys
+	@return BLS_OK if verified, otherwise BLS_FAIL
+ */
+int BLS_FAST_AGGREGATE_VERIFY(octet *AS,char *m,octet *W,int n);
+/**	@brief Verify an aggregate signature of distinct messages
+ *
+	Checked as one (n+1)-pairing with a single final exponentiation. Fails if any two messages are the same, or if AS or any public key is not a valid point, or is infinity
+	More than 16 messages are sorted in place to find repeats, so m and W may be reordered, with each W[i] kept with its m[i]
+	@param AS an input aggregate signature
+	@param m array of n messages
+	@param W array of n public keys, W[i] the signer of m[i]
+	@param n number of messages
+	@return BLS_OK if verified, otherwise BLS_FAIL
+ */
+int BLS_AGGREGATE_VERIFY(octet *AS,char **m,octet *W,int n);
 }
 
 #endif
@@ -109,6 +109,7 @@ def curveset(tb,tf,tc,nb,base,nbt,m8,mt,ct,pf,stw,sx,ab,cs) :
 	replace(fnameh,"@SX@",sx)
 	replace(fnameh,"@CS@",cs)
 	replace(fnameh,"@AB@",ab)
+	replace(fnameh,"@MW@","4")
 
 
 	fnamec="big_"+bd+".cpp"
@@ -12,6 +12,14 @@ if sys.platform.startswith("win") :
 	deltext="del"
 	copytext="copy"
 
+# Set to True to use the x86-64 MULX/ADX backend for BIG multiplication, squaring and Montgomery reduction
+# Requires Intel Broadwell, AMD Zen or later processor
+mulx=False
+
+# Set to True to use the AVX-512 IFMA backend for FP_mul_x8 with Montgomery moduli
+# Requires Intel Ice Lake or later processor
+ifma=False
+
 def replace(namefile,oldtext,newtext):
 	f = open(namefile,'r')
 	filedata = f.read()
@@ -24,6 +32,205 @@ def replace(namefile,oldtext,newtext):
 	f.close()
 
 
+# Generate fully unrolled Comba code for BIG_mul, BIG_sqr and BIG_monty (see faster.c)
+# Loop structure must exactly mirror the looped code in big.cpp
+
+def unwound_mul(N) :
+	s=""
+	for i in range(0,N) :
+		s+="\td["+str(i)+"]=(dchunk)a["+str(i)+"]*b["+str(i)+"];\n"
+	s+="\n\ts=d[0];\n\tt=s; c[0]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	for k in range(1,N) :
+		s+="\ts+=d["+str(k)+"]; t=co+s"
+		for i in range(k,k//2,-1) :
+			s+="+(dchunk)(a["+str(i)+"]-a["+str(k-i)+"])*(b["+str(k-i)+"]-b["+str(i)+"])"
+		s+="; c["+str(k)+"]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	s+="\n"
+	for k in range(N,2*N-1) :
+		s+="\ts-=d["+str(k-N)+"]; t=co+s"
+		for i in range(N-1,k//2,-1) :
+			s+="+(dchunk)(a["+str(i)+"]-a["+str(k-i)+"])*(b["+str(k-i)+"]-b["+str(i)+"])"
+		s+="; c["+str(k)+"]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	s+="\tc["+str(2*N-1)+"]=(chunk)co;\n"
+	return s
+
+def unwound_sqr(N) :
+	s="\tt=(dchunk)a[0]*a[0]; c[0]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	for k in range(1,2*N-2) :
+		s+="\tt="
+		for i in range(min(k,N-1),k//2,-1) :
+			if i!=min(k,N-1) :
+				s+="+"
+			s+="(dchunk)a["+str(i)+"]*a["+str(k-i)+"]"
+		s+="; t+=t; t+=co;"
+		if k%2==0 :
+			s+=" t+=(dchunk)a["+str(k//2)+"]*a["+str(k//2)+"];"
+		s+=" c["+str(k)+"]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	s+="\tt=(dchunk)a["+str(N-1)+"]*a["+str(N-1)+"]+co; c["+str(2*N-2)+"]=(chunk)t&BMASK_XXX; co=t>>BASEBITS_XXX;\n"
+	s+="\tc["+str(2*N-1)+"]=(chunk)co;\n"
+	return s
+
+def unwound_monty(N) :
+	s="\tt=d[0]; v[0]=((chunk)t*MC)&BMASK_XXX; t+=(dchunk)v[0]*md[0]; c=(t>>BASEBITS_XXX)+d[1]; s=0;\n\n"
+	for k in range(1,N) :
+		s+="\tt=c+s+(dchunk)v[0]*md["+str(k)+"]"
+		for i in range(k-1,k//2,-1) :
+			s+="+(dchunk)(v["+str(k-i)+"]-v["+str(i)+"])*(md["+str(i)+"]-md["+str(k-i)+"])"
+		s+="; v["+str(k)+"]=((chunk)t*MC)&BMASK_XXX; t+=(dchunk)v["+str(k)+"]*md[0]; c=(t>>BASEBITS_XXX)+d["+str(k+1)+"];"
+		s+=" dd["+str(k)+"]=(dchunk)v["+str(k)+"]*md["+str(k)+"]; s+=dd["+str(k)+"];\n"
+	s+="\n"
+	for k in range(N,2*N-1) :
+		s+="\tt=c+s"
+		for i in range(N-1,k//2,-1) :
+			s+="+(dchunk)(v["+str(k-i)+"]-v["+str(i)+"])*(md["+str(i)+"]-md["+str(k-i)+"])"
+		s+="; a["+str(k-N)+"]=(chunk)t&BMASK_XXX; c=(t>>BASEBITS_XXX)+d["+str(k+1)+"]; s-=dd["+str(k-N+1)+"];\n"
+	s+="\ta["+str(N-1)+"]=(chunk)c&BMASK_XXX;\n"
+	return s
+
+def unwind(fnamec,nb,base) :
+	N=1+((8*int(nb)-1)//int(base))
+	replace(fnamec,"@UMUL@",unwound_mul(N))
+	replace(fnamec,"@USQR@",unwound_sqr(N))
+	replace(fnamec,"@UMON@",unwound_monty(N))
+
+# Generate interleaved Comba multiplication and Montgomery reduction FP_modmul() (see fastest.c)
+# Only used if column sums cannot overflow a dchunk
+
+def fused_modmul(N,base,wl) :
+	if (3*N)<<(2*base) >= 1<<(2*wl-1) :
+		return ""
+	s="void YYY::FP_modmul(BIG r,BIG a,BIG b)\n{\n"
+	s+="\tdchunk t,c,s;\n\tdchunk d["+str(N)+"],dd["+str(N)+"];\n\tchunk v["+str(N)+"],md["+str(N)+"];\n"
+	s+="\tchunk MC=MConst;\n\n\tBIG_rcopy(md,Modulus);\n\n"
+	for i in range(0,N) :
+		s+="\td["+str(i)+"]=(dchunk)a["+str(i)+"]*b["+str(i)+"];\n"
+	s+="\n\ts=d[0]; t=s; v[0]=((chunk)t*MC)&BMASK_XXX; t+=(dchunk)v[0]*md[0]; c=(t>>BASEBITS_XXX);\n\n"
+	for k in range(1,N) :
+		s+="\ts+=d["+str(k)+"]; t=c+s"
+		for i in range(k,k//2,-1) :
+			s+="+(dchunk)(a["+str(i)+"]-a["+str(k-i)+"])*(b["+str(k-i)+"]-b["+str(i)+"])"
+		s+="+(dchunk)v[0]*md["+str(k)+"]"
+		for i in range(k-1,k//2,-1) :
+			s+="+(dchunk)(v["+str(k-i)+"]-v["+str(i)+"])*(md["+str(i)+"]-md["+str(k-i)+"])"
+		s+="; v["+str(k)+"]=((chunk)t*MC)&BMASK_XXX; t+=(dchunk)v["+str(k)+"]*md[0]; c=(t>>BASEBITS_XXX);"
+		s+=" dd["+str(k)+"]=(dchunk)v["+str(k)+"]*md["+str(k)+"]; s+=dd["+str(k)+"];\n"
+	s+="\n"
+	for k in range(N,2*N-1) :
+		s+="\ts-=d["+str(k-N)+"]; t=c+s"
+		for i in range(N-1,k//2,-1) :
+			s+="+(dchunk)(a["+str(i)+"]-a["+str(k-i)+"])*(b["+str(k-i)+"]-b["+str(i)+"])"
+		for i in range(N-1,k//2,-1) :
+			s+="+(dchunk)(v["+str(k-i)+"]-v["+str(i)+"])*(md["+str(i)+"]-md["+str(k-i)+"])"
+		s+="; r["+str(k-N)+"]=(chunk)t&BMASK_XXX; c=(t>>BASEBITS_XXX); s-=dd["+str(k-N+1)+"];\n"
+	s+="\tr["+str(N-1)+"]=(chunk)c&BMASK_XXX;\n}\n"
+	return s
+
+# Time unrolled against looped code, and use whichever is faster
+
+unwound={}
+fused={}
+
+def timeit(fnamet,srcs,flags) :
+	exe=fnamet[:-4]
+	if sys.platform.startswith("win") :
+		exe=exe+".exe"
+		run=exe
+	else :
+		run="./"+exe
+	os.system("g++ -O3 "+flags+" "+fnamet+" "+srcs+" rand.cpp hash.cpp -o "+exe)
+	best=0
+	for i in range(0,3) :
+		t=int(os.popen(run).read())
+		if i==0 or t<best :
+			best=t
+	os.system(deltext+" "+exe)
+	return best
+
+def tune(bd) :
+	if bd in unwound :
+		return unwound[bd]
+
+	fnamet="tune_"+bd+".cpp"
+	f=open(fnamet,'w')
+	f.write("#include <time.h>\n#include \"big_"+bd+".cpp\"\n\n")
+	f.write("using namespace "+bd+";\n\n")
+	f.write("int main()\n{\n\tint i;\n\tBIG a,b,m;\n\tDBIG d;\n\tclock_t start;\n")
+	f.write("\tfor (i=0;i<NLEN_"+bd+";i++)\n\t{\n")
+	f.write("\t\ta[i]=((chunk)0x5DEECE66D*(i+1))&BMASK_"+bd+";\n")
+	f.write("\t\tb[i]=((chunk)0x2545F4914F*(i+3))&BMASK_"+bd+";\n")
+	f.write("\t\tm[i]=((chunk)0x41C64E6D*(i+7))&BMASK_"+bd+";\n\t}\n")
+	f.write("\tm[0]|=1;\n\tstart=clock();\n")
+	f.write("\tfor (i=0;i<1000000;i++)\n\t{\n")
+	f.write("\t\tBIG_mul(d,a,b);\n\t\tBIG_monty(b,m,(chunk)0x7E5,d);\n")
+	f.write("\t\tBIG_sqr(d,a);\n\t\tBIG_monty(a,m,(chunk)0x7E5,d);\n\t}\n")
+	f.write("\tprintf(\"%d\\n\",(int)(clock()-start));\n\treturn 0;\n}\n")
+	f.close()
+
+	looped=timeit(fnamet,"","")
+	unrolled=timeit(fnamet,"","-DUNWOUND_"+bd)
+	os.system(deltext+" "+fnamet)
+
+	unwound[bd]=unrolled<looped
+	if unwound[bd] :
+		print("BIG_"+bd+" unrolled")
+	return unwound[bd]
+
+def tunefp(tf,bd) :
+	if tf in fused :
+		return fused[tf]
+
+	fnamet="tune_"+tf+".cpp"
+	f=open(fnamet,'w')
+	f.write("#include <time.h>\n#include \"fp_"+tf+".h\"\n\n")
+	f.write("using namespace "+bd+";\nusing namespace "+tf+";\n\n")
+	f.write("int main()\n{\n\tint i;\n\tBIG x;\n\tFP a,b;\n\tclock_t start;\n")
+	f.write("\tfor (i=0;i<NLEN_"+bd+"-1;i++)\n")
+	f.write("\t\tx[i]=((chunk)0x5DEECE66D*(i+1))&BMASK_"+bd+";\n")
+	f.write("\tx[NLEN_"+bd+"-1]=0;\n\tFP_nres(&a,x);\n\tFP_copy(&b,&a);\n\tstart=clock();\n")
+	f.write("\tfor (i=0;i<1000000;i++)\n\t\tFP_mul(&a,&a,&b);\n")
+	f.write("\tprintf(\"%d\\n\",(int)(clock()-start));\n\treturn 0;\n}\n")
+	f.close()
+
+	srcs="fp_"+tf+".cpp big_"+bd+".cpp rom_field_"+tf+".cpp"
+	separate=timeit(fnamet,srcs,"")
+	combined=timeit(fnamet,srcs,"-DFUSED_MODMUL_"+tf)
+	os.system(deltext+" "+fnamet)
+
+	fused[tf]=combined<separate
+	if fused[tf] :
+		print("FP_"+tf+" fused")
+	return fused[tf]
+
+# Time ECP_mul with 4, 5 and 6 bit windows. A wider window must be clearly faster to be used
+
+def tunewin(tc,tf,bd) :
+	fnameh="config_curve_"+tc+".h"
+	fnamet="tunew_"+tc+".cpp"
+	f=open(fnamet,'w')
+	f.write("#include <time.h>\n#include \"ecp_"+tc+".h\"\n\n")
+	f.write("using namespace "+bd+";\nusing namespace "+tc+";\n\n")
+	f.write("int main()\n{\n\tint i;\n\tBIG e;\n\tECP P;\n\tclock_t start;\n")
+	f.write("\tECP_generator(&P);\n\tBIG_rcopy(e,CURVE_Order);\n\tBIG_dec(e,1);\n\tBIG_norm(e);\n\tstart=clock();\n")
+	f.write("\tfor (i=0;i<200;i++)\n\t\tECP_mul(&P,e);\n")
+	f.write("\tprintf(\"%d\\n\",(int)(clock()-start));\n\treturn 0;\n}\n")
+	f.close()
+
+	srcs="ecp_"+tc+".cpp rom_curve_"+tc+".cpp fp_"+tf+".cpp big_"+bd+".cpp rom_field_"+tf+".cpp"
+	best=0
+	win="4"
+	for w in ["4","5","6"] :
+		replace(fnameh,"@MW@",w)
+		t=timeit(fnamet,srcs,"")
+		replace(fnameh,"MUL_WINDOW_"+tc+" "+w,"MUL_WINDOW_"+tc+" @MW@")
+		if w=="4" or t<0.98*best :
+			best=t
+			win=w
+	os.system(deltext+" "+fnamet)
+
+	if win!="4" :
+		print("ECP_"+tc+" "+win+"-bit windows")
+	return win
+
 def rsaset(tb,tff,nb,base,ml) :
 	bd="B"+tb+"_"+base
 	fnameh="config_big_"+bd+".h"
@@ -44,8 +251,13 @@ def rsaset(tb,tff,nb,base,ml) :
 	os.system(copytext+" big.cpp "+fnamec)
 	os.system(copytext+" big.h "+fnameh)
 
+	unwind(fnamec,nb,base)
 	replace(fnamec,"XXX",bd)
 	replace(fnameh,"XXX",bd)
+	if mulx :
+		replace(fnameh,"//#define MULX_"+bd,"#define MULX_"+bd)
+	elif tune(bd) :
+		replace(fnameh,"//#define UNWOUND_"+bd,"#define UNWOUND_"+bd)
 	os.system("g++ -O3 -c "+fnamec)
 
 	fnamec="ff_"+tff+".cpp"
@@ -109,6 +321,8 @@ def curveset(tb,tf,tc,nb,base,nbt,m8,mt,ct,pf,stw,sx,ab,cs) :
 	replace(fnameh,"@SX@",sx)
 	replace(fnameh,"@CS@",cs)
 	replace(fnameh,"@AB@",ab)
+	if tc == "SECP256K1" :
+		replace(fnameh,"//#define USE_GLV_ECP_"+tc,"#define USE_GLV_ECP_"+tc)
 
 
 	fnamec="big_"+bd+".cpp"
@@ -117,8 +331,13 @@ def curveset(tb,tf,tc,nb,base,nbt,m8,mt,ct,pf,stw,sx,ab,cs) :
 	os.system(copytext+" big.cpp "+fnamec)
 	os.system(copytext+" big.h "+fnameh)
 
+	unwind(fnamec,nb,base)
 	replace(fnamec,"XXX",bd)
 	replace(fnameh,"XXX",bd)
+	if mulx :
+		replace(fnameh,"//#define MULX_"+bd,"#define MULX_"+bd)
+	elif tune(bd) :
+		replace(fnameh,"//#define UNWOUND_"+bd,"#define UNWOUND_"+bd)
 	os.system("g++ -O3 -c "+fnamec)
 
 	fnamec="fp_"+tf+".cpp"
@@ -127,10 +346,18 @@ def curveset(tb,tf,tc,nb,base,nbt,m8,mt,ct,pf,stw,sx,ab,cs) :
 	os.system(copytext+" fp.cpp "+fnamec)
 	os.system(copytext+" fp.h "+fnameh)
 
+	modmul=""
+	if mt == "NOT_SPECIAL" :
+		modmul=fused_modmul(1+((8*inb-1)//ib),ib,64)
+	replace(fnamec,"@FMUL@",modmul)
 	replace(fnamec,"YYY",tf)
 	replace(fnamec,"XXX",bd)
 	replace(fnameh,"YYY",tf)
 	replace(fnameh,"XXX",bd)
+	if modmul != "" and tunefp(tf,bd) :
+		replace(fnameh,"//#define FUSED_MODMUL_"+tf,"#define FUSED_MODMUL_"+tf)
+	if ifma and (mt == "NOT_SPECIAL" or mt == "MONTGOMERY_FRIENDLY") :
+		replace(fnameh,"//#define IFMA_"+tf,"#define IFMA_"+tf)
 	os.system("g++ -O3 -c "+fnamec)
 
 	os.system("g++ -O3 -c rom_field_"+tf+".cpp")
@@ -147,6 +374,10 @@ def curveset(tb,tf,tc,nb,base,nbt,m8,mt,ct,pf,stw,sx,ab,cs) :
 	replace(fnameh,"ZZZ",tc)
 	replace(fnameh,"YYY",tf)
 	replace(fnameh,"XXX",bd)
+	mw="4"
+	if ct != "MONTGOMERY" and tc != "SECP256K1" :
+		mw=tunewin(tc,tf,bd)
+	replace("config_curve_"+tc+".h","@MW@",mw)
 	os.system("g++ -O3 -c "+fnamec)
 
 	fnamec="ecdh_"+tc+".cpp"
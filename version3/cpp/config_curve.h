@@ -9,6 +9,11 @@
 #define CURVETYPE_ZZZ @CT@  
 #define PAIRING_FRIENDLY_ZZZ @PF@
 #define CURVE_SECURITY_ZZZ @CS@
+#define PRECOMP_WINDOW_ZZZ 5 /**< Comb width (teeth) of ECP_precomp and ECP2_precomp tables, and of the ECP4_mul_gen and ECP8_mul_gen combs, 5 to 8 */
+#define PRECOMP_BLOCKS_ZZZ 2 /**< Number of combs in ECP_precomp and ECP2_precomp tables, and in the ECP4_mul_gen and ECP8_mul_gen combs */
+#define MUL_WINDOW_ZZZ @MW@ /**< Width of signed windows in ECP_mul, ECP2_mul, ECP4_mul and ECP8_mul, 4 to 6. Chosen by config script */
+
+//#define USE_GLV_ECP_ZZZ /**< Curve has the endomorphism (x,y)->(Beta.x,y) and GLV constants in its ROM, so ECP_mul and ECP_mul2 use GLV. Set by config script */
 
 #if PAIRING_FRIENDLY_ZZZ != NOT
 #define USE_GLV_ZZZ	  /**< Note this method is patented (GLV), so maybe you want to comment this out */
@@ -40,8 +40,6 @@ int ZZZ::ECP_KEY_PAIR_GENERATE(csprng *RNG,octet* S,octet *W)
     ECP G;
     int res=0;
 
-	ECP_generator(&G);
-
     BIG_rcopy(r,CURVE_Order);
     if (RNG!=NULL)
     {
@@ -61,7 +59,7 @@ int ZZZ::ECP_KEY_PAIR_GENERATE(csprng *RNG,octet* S,octet *W)
     BIG_toBytes(S->val,s);
 
 
-    ECP_mul(&G,s);
+    ECP_mul_gen(&G,s);
 
 	ECP_toOctet(W,&G,false);	// To use point compression on public keys, change to true 
 
@@ -138,6 +136,46 @@ int ZZZ::ECP_SVDP_DH(octet *S,octet *WD,octet *Z)
     return res;
 }
 
+#if CURVETYPE_ZZZ==MONTGOMERY
+
+/* RFC 7748 Diffie-Hellman function, as X25519. K=S.U, where U and K are u-coordinates */
+/* All strings are little-endian. S is clamped, and U has any bits above MODBITS_YYY masked */
+int ZZZ::ECP_XDH(octet *S,octet *U,octet *K)
+{
+    int i,c;
+    char b[MODBYTES_XXX];
+    BIG s,u,r,t;
+
+    if (S->len!=EGS_ZZZ || U->len!=EFS_ZZZ) return ECDH_ERROR;
+
+    for (i=0; i<MODBYTES_XXX; i++) b[i]=S->val[MODBYTES_XXX-1-i];
+    BIG_fromBytes(s,b);
+    for (i=0; i<MODBYTES_XXX; i++) b[i]=U->val[MODBYTES_XXX-1-i];
+    BIG_fromBytes(u,b);
+
+    /* clamp - clear the cofactor bits, and set the top bit */
+    for (c=0; (1<<c)<CURVE_Cof_I; c++) ;
+    BIG_fshr(s,c);
+    BIG_fshl(s,c);
+    BIG_mod2m(s,MODBITS_YYY-1);
+    BIG_one(t);
+    BIG_shl(t,MODBITS_YYY-1);
+    BIG_add(s,s,t);
+    BIG_norm(s);
+    BIG_mod2m(u,MODBITS_YYY);
+
+    ECP_ladder(r,s,u);
+
+    BIG_toBytes(b,r);
+    for (i=0; i<MODBYTES_XXX; i++) K->val[i]=b[MODBYTES_XXX-1-i];
+    K->len=MODBYTES_XXX;
+
+    if (BIG_iszilch(r)) return ECDH_ERROR;
+    return 0;
+}
+
+#endif
+
 #if CURVETYPE_ZZZ!=MONTGOMERY
 
 /* IEEE ECDSA Signature, C and D are signature on F using private key S */
@@ -147,12 +185,10 @@ int ZZZ::ECP_SP_DSA(int sha,csprng *RNG,octet *K,octet *S,octet *F,octet *C,octe
     octet H= {0,sizeof(h),h};
 
     BIG r,s,f,c,d,u,vx,w;
-    ECP G,V;
+    ECP V;
 
     ehashit(sha,F,-1,NULL,&H,sha);
 
-	ECP_generator(&G);
-
 	BIG_rcopy(r,CURVE_Order);
 
     BIG_fromBytes(s,S->val);
@@ -172,8 +208,7 @@ int ZZZ::ECP_SP_DSA(int sha,csprng *RNG,octet *K,octet *S,octet *F,octet *C,octe
 #ifdef AES_S
 			BIG_mod2m(u,2*AES_S);
 #endif
-			ECP_copy(&V,&G);
-			ECP_mul(&V,u);
+			ECP_mul_gen(&V,u);
 
 			ECP_get(vx,vx,&V);
 
@@ -204,8 +239,7 @@ int ZZZ::ECP_SP_DSA(int sha,csprng *RNG,octet *K,octet *S,octet *F,octet *C,octe
 #ifdef AES_S
 		BIG_mod2m(u,2*AES_S);
 #endif
-		ECP_copy(&V,&G);
-		ECP_mul(&V,u);
+		ECP_mul_gen(&V,u);
 
 		ECP_get(vx,vx,&V);
 
@@ -86,6 +86,18 @@ extern int  ECP_PUBLIC_KEY_VALIDATE(octet *W);
 	@return 0 or an error code
  */
 extern int ECP_SVDP_DH(octet *s,octet *W,octet *K);
+#if CURVETYPE_ZZZ==MONTGOMERY
+/**	@brief RFC 7748 Diffie-Hellman function, as X25519
+ *
+	Uses the x-only ladder ECP_ladder. All strings are little-endian, as in RFC 7748, and the scalar is clamped.
+	A public key is the result of this function with U the u-coordinate of the generator
+	@param s the private key, EGS bytes
+	@param U the u-coordinate of the other party's public key, EFS bytes
+	@param K the output, EFS bytes
+	@return 0, or an error code if the lengths are wrong, or if K is zero because U has small order
+ */
+extern int ECP_XDH(octet *s,octet *U,octet *K);
+#endif
 /*extern int ECPSVDP_DHC(octet *,octet *,int,octet *);*/
 
 /*#if CURVETYPE!=MONTGOMERY */
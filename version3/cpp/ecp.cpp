@@ -24,9 +24,19 @@ under the License.
 
 #include "ecp_ZZZ.h"
 
+#ifdef THREADS
+#include <pthread.h>
+#endif
+
 using namespace XXX;
 using namespace YYY;
 
+#ifdef USE_GLV_ECP_ZZZ
+namespace ZZZ {
+	static void ECP_mul2_window(ECP *,ECP *,BIG,BIG);
+}
+#endif
+
 /* test for P=O point-at-infinity */
 int ZZZ::ECP_isinf(ECP *P)
 {
@@ -75,24 +85,19 @@ static int teq(sign32 b,sign32 c)
 }
 #endif // CURVETYPE_ZZZ!=MONTGOMERY
 
-#if CURVETYPE_ZZZ!=MONTGOMERY
-/* Constant time select from pre-computed table */
-static void ECP_select(ZZZ::ECP *P,ZZZ::ECP W[],sign32 b)
+#if CURVETYPE_ZZZ==WEIERSTRASS
+/* Constant time select from pre-computed table of n odd multiples */
+static void ECP_select(ZZZ::ECP *P,ZZZ::ECP W[],sign32 b,int n)
 {
+    int i;
     ZZZ::ECP MP;
     sign32 m=b>>31;
     sign32 babs=(b^m)-m;
 
     babs=(babs-1)/2;
 
-    ECP_cmove(P,&W[0],teq(babs,0));  // conditional move
-    ECP_cmove(P,&W[1],teq(babs,1));
-    ECP_cmove(P,&W[2],teq(babs,2));
-    ECP_cmove(P,&W[3],teq(babs,3));
-    ECP_cmove(P,&W[4],teq(babs,4));
-    ECP_cmove(P,&W[5],teq(babs,5));
-    ECP_cmove(P,&W[6],teq(babs,6));
-    ECP_cmove(P,&W[7],teq(babs,7));
+    for (i=0; i<n; i++)
+        ECP_cmove(P,&W[i],teq(babs,i));  // conditional move
 
     ECP_copy(&MP,P);
     ECP_neg(&MP);  // minus P
@@ -232,16 +237,13 @@ void ZZZ::ECP_rhs(FP *v,FP *x)
 
 int ZZZ::ECP_set(ECP *P,BIG x)
 {
-    BIG m,b;
 	FP rhs;
-    BIG_rcopy(m,Modulus);
 
 	FP_nres(&rhs,x);
 
     ECP_rhs(&rhs,&rhs);
-    FP_redc(b,&rhs);
 
-    if (BIG_jacobi(b,m)!=1)
+    if (!FP_qr(&rhs))
     {
         ECP_inf(P);
         return 0;
@@ -314,23 +316,50 @@ int ZZZ::ECP_set(ECP *P,BIG x,BIG y)
 /* SU=136 */
 int ZZZ::ECP_setx(ECP *P,BIG x,int s)
 {
-    FP rhs;
-	BIG t,m;
-    BIG_rcopy(m,Modulus);
+    FP rhs,i;
+	BIG t;
 
     FP_nres(&rhs,x);
 
+#if CURVETYPE_ZZZ==EDWARDS
+    /* y^2=u/v where u=Ax^2-1 and v=Bx^2-1, so y=u/sqrt(u.v) avoids an inversion */
+	FP u,v,one;
+    FP_sqr(&u,&rhs);
+    FP_one(&one);
+    FP_rcopy(&v,CURVE_B);
+
+    FP_mul(&v,&u,&v);
+    FP_sub(&v,&v,&one);
+	FP_norm(&v);
+    if (CURVE_A==1) FP_sub(&u,&u,&one);
+
+    if (CURVE_A==-1)
+    {
+        FP_add(&u,&u,&one);
+		FP_norm(&u);
+        FP_neg(&u,&u);
+    }
+	FP_norm(&u);
+    FP_mul(&v,&u,&v);
+
+    if (!FP_invsqrt(&i,&v,&v))
+    {
+        ECP_inf(P);
+        return 0;
+    }
+    FP_mul(&(P->y),&u,&i);
+    FP_reduce(&(P->y));
+#else
     ECP_rhs(&rhs,&rhs);
- 
-    FP_redc(t,&rhs);
-    if (BIG_jacobi(t,m)!=1)
+
+    if (!FP_invsqrt(&i,&(P->y),&rhs))
     {
         ECP_inf(P);
         return 0;
     }
+#endif
 
     FP_nres(&(P->x),x);
-    FP_sqrt(&(P->y),&rhs);
 
     FP_redc(t,&(P->y));
 
@@ -367,6 +396,67 @@ void ZZZ::ECP_affine(ECP *P)
     FP_copy(&(P->z),&one);
 }
 
+#define AFFINE_BATCH 8 /* maximum number of points sharing one inversion */
+#if CURVETYPE_ZZZ==EDWARDS || CURVETYPE_ZZZ==WEIERSTRASS
+#define AFFINE_GROUP 4 /* points whose x and y make up the 8 products of one FP_mul_x8 */
+#else
+#define AFFINE_GROUP 8
+#endif
+
+/* Convert n points to affine, with one inversion per AFFINE_BATCH points */
+void ZZZ::ECP_affine_batch(ECP *P,int n)
+{
+	int i,j,k,g,m,h;
+	FP z[AFFINE_BATCH],iz[AFFINE_BATCH];
+	FP c[8],s[8];
+
+	for (j=0;j<n;j+=AFFINE_BATCH)
+	{
+		m=n-j;
+		if (m>AFFINE_BATCH) m=AFFINE_BATCH;
+		for (i=0;i<m;i++)
+			FP_copy(&z[i],&(P[j+i].z));
+
+		FP_inv_batch(iz,z,m);
+
+		for (g=0;g<m;g+=AFFINE_GROUP)
+		{
+			h=m-g;
+			if (h>AFFINE_GROUP) h=AFFINE_GROUP;
+
+/* gather the coordinates of finite points, so they can be multiplied by 1/z eight at a time */
+			k=0;
+			for (i=g;i<g+h;i++)
+			{
+				if (ECP_isinf(&P[j+i])) continue;
+				FP_copy(&c[k],&(P[j+i].x));
+				FP_copy(&s[k++],&iz[i]);
+#if CURVETYPE_ZZZ==EDWARDS || CURVETYPE_ZZZ==WEIERSTRASS
+				FP_copy(&c[k],&(P[j+i].y));
+				FP_copy(&s[k++],&iz[i]);
+#endif
+			}
+			if (k==8)
+				FP_mul_x8(c,c,s);
+			else for (i=0;i<k;i++)
+				FP_mul(&c[i],&c[i],&s[i]);
+
+			k=0;
+			for (i=g;i<g+h;i++)
+			{
+				if (ECP_isinf(&P[j+i])) continue;
+				FP_copy(&(P[j+i].x),&c[k++]);
+				FP_reduce(&(P[j+i].x));
+#if CURVETYPE_ZZZ==EDWARDS || CURVETYPE_ZZZ==WEIERSTRASS
+				FP_copy(&(P[j+i].y),&c[k++]);
+				FP_reduce(&(P[j+i].y));
+#endif
+				FP_one(&(P[j+i].z));
+			}
+		}
+	}
+}
+
 /* SU=120 */
 void ZZZ::ECP_outputxyz(ECP *P)
 {
@@ -931,6 +1021,191 @@ void ZZZ::ECP_add(ECP *P,ECP *Q)
 #endif
 }
 
+/* Set P+=Q, where Q is in affine form (Z=1) and is not the point at infinity */
+/* Mixed addition formulas, saving one multiplication and some additions over ECP_add */
+static void ECP_addaff(ZZZ::ECP *P,ZZZ::ECP *Q)
+{
+#if CURVETYPE_ZZZ==WEIERSTRASS
+
+	int b3;
+	FP t0,t1,t2,t3,t4,x3,y3,z3,b;
+
+	if (ZZZ::CURVE_A==0)
+	{
+		b3=3*ZZZ::CURVE_B_I;
+		FP_mul(&t0,&(P->x),&(Q->x));
+		FP_mul(&t1,&(P->y),&(Q->y));
+		FP_add(&t3,&(P->x),&(P->y));
+		FP_norm(&t3);
+		FP_add(&t4,&(Q->x),&(Q->y));
+		FP_norm(&t4);
+		FP_mul(&t3,&t3,&t4);
+		FP_add(&t4,&t0,&t1);
+
+		FP_sub(&t3,&t3,&t4);
+		FP_norm(&t3);
+		FP_mul(&t4,&(Q->y),&(P->z));
+		FP_add(&t4,&t4,&(P->y));
+		FP_norm(&t4);
+
+		FP_mul(&y3,&(Q->x),&(P->z));
+		FP_add(&y3,&y3,&(P->x));
+		FP_norm(&y3);
+		FP_add(&x3,&t0,&t0);
+		FP_add(&t0,&t0,&x3);
+		FP_norm(&t0);
+		FP_imul(&t2,&(P->z),b3);
+
+		FP_add(&z3,&t1,&t2);
+		FP_norm(&z3);
+		FP_sub(&t1,&t1,&t2);
+		FP_norm(&t1);
+		FP_imul(&y3,&y3,b3);
+
+		FP_mul(&x3,&y3,&t4);
+		FP_mul(&t2,&t3,&t1);
+		FP_sub(&(P->x),&t2,&x3);
+		FP_mul(&y3,&y3,&t0);
+		FP_mul(&t1,&t1,&z3);
+		FP_add(&(P->y),&y3,&t1);
+		FP_mul(&t0,&t0,&t3);
+		FP_mul(&z3,&z3,&t4);
+		FP_add(&(P->z),&z3,&t0);
+
+		FP_norm(&(P->x));
+		FP_norm(&(P->y));
+		FP_norm(&(P->z));
+	}
+	else
+	{
+		if (ZZZ::CURVE_B_I==0)
+			FP_rcopy(&b,ZZZ::CURVE_B);
+
+		FP_mul(&t0,&(P->x),&(Q->x));
+		FP_mul(&t1,&(P->y),&(Q->y));
+		FP_copy(&t2,&(P->z));
+
+		FP_add(&t3,&(P->x),&(P->y));
+		FP_norm(&t3);
+		FP_add(&t4,&(Q->x),&(Q->y));
+		FP_norm(&t4);
+		FP_mul(&t3,&t3,&t4);
+		FP_add(&t4,&t0,&t1);
+		FP_sub(&t3,&t3,&t4);
+		FP_norm(&t3);
+		FP_mul(&t4,&(Q->y),&(P->z));
+		FP_add(&t4,&t4,&(P->y));
+		FP_norm(&t4);
+
+		FP_mul(&y3,&(Q->x),&(P->z));
+		FP_add(&y3,&y3,&(P->x));
+		FP_norm(&y3);
+
+		if (ZZZ::CURVE_B_I==0)
+			FP_mul(&z3,&t2,&b);
+		else
+			FP_imul(&z3,&t2,ZZZ::CURVE_B_I);
+
+		FP_sub(&x3,&y3,&z3);
+		FP_norm(&x3);
+		FP_add(&z3,&x3,&x3);
+
+		FP_add(&x3,&x3,&z3);
+		FP_sub(&z3,&t1,&x3);
+		FP_norm(&z3);
+		FP_add(&x3,&x3,&t1);
+		FP_norm(&x3);
+
+		if (ZZZ::CURVE_B_I==0)
+			FP_mul(&y3,&y3,&b);
+		else
+			FP_imul(&y3,&y3,ZZZ::CURVE_B_I);
+
+		FP_add(&t1,&t2,&t2);
+		FP_add(&t2,&t2,&t1);
+
+		FP_sub(&y3,&y3,&t2);
+
+		FP_sub(&y3,&y3,&t0);
+		FP_norm(&y3);
+		FP_add(&t1,&y3,&y3);
+		FP_add(&y3,&y3,&t1);
+		FP_norm(&y3);
+
+		FP_add(&t1,&t0,&t0);
+		FP_add(&t0,&t0,&t1);
+		FP_sub(&t0,&t0,&t2);
+		FP_norm(&t0);
+		FP_mul(&t1,&t4,&y3);
+		FP_mul(&t2,&t0,&y3);
+		FP_mul(&y3,&x3,&z3);
+		FP_add(&(P->y),&y3,&t2);
+		FP_mul(&x3,&x3,&t3);
+		FP_sub(&(P->x),&x3,&t1);
+		FP_mul(&z3,&z3,&t4);
+
+		FP_mul(&t1,&t3,&t0);
+		FP_add(&(P->z),&z3,&t1);
+		FP_norm(&(P->x));
+		FP_norm(&(P->y));
+		FP_norm(&(P->z));
+	}
+
+#else
+	FP A,B,C,D,E,F,G,b;
+
+	FP_copy(&A,&(P->z));
+	FP_sqr(&B,&A);
+	FP_mul(&C,&(P->x),&(Q->x));
+	FP_mul(&D,&(P->y),&(Q->y));
+
+	FP_mul(&E,&C,&D);
+
+	if (ZZZ::CURVE_B_I==0)
+	{
+		FP_rcopy(&b,ZZZ::CURVE_B);
+		FP_mul(&E,&E,&b);
+	}
+	else
+		FP_imul(&E,&E,ZZZ::CURVE_B_I);
+
+	FP_sub(&F,&B,&E);
+	FP_add(&G,&B,&E);
+
+	if (ZZZ::CURVE_A==1)
+	{
+		FP_sub(&E,&D,&C);
+	}
+	FP_add(&C,&C,&D);
+
+	FP_add(&B,&(P->x),&(P->y));
+	FP_add(&D,&(Q->x),&(Q->y));
+	FP_norm(&B);
+	FP_norm(&D);
+	FP_mul(&B,&B,&D);
+	FP_sub(&B,&B,&C);
+	FP_norm(&B);
+	FP_norm(&F);
+	FP_mul(&B,&B,&F);
+	FP_mul(&(P->x),&A,&B);
+	FP_norm(&G);
+
+	if (ZZZ::CURVE_A==1)
+	{
+		FP_norm(&E);
+		FP_mul(&C,&E,&G);
+	}
+	if (ZZZ::CURVE_A==-1)
+	{
+		FP_norm(&C);
+		FP_mul(&C,&C,&G);
+	}
+	FP_mul(&(P->y),&A,&C);
+	FP_mul(&(P->z),&F,&G);
+
+#endif
+}
+
 /* Set P-=Q */
 /* SU=16 */
 void  ZZZ::ECP_sub(ECP *P,ECP *Q)
@@ -943,6 +1218,211 @@ void  ZZZ::ECP_sub(ECP *P,ECP *Q)
 
 #endif
 
+#if CURVETYPE_ZZZ==EDWARDS
+
+/* Edwards point in extended coordinates (X:Y:Z:T), where x=X/Z, y=Y/Z and T=XY/Z - see Hisil, Wong, Carter and Dawson, "Twisted Edwards Curves Revisited" */
+/* Points in tables, which are only ever added, are held in table form - (Y+X:Y-X:2Z:2dT) if a=-1, and (X:Y:Z:dT) otherwise */
+typedef struct
+{
+    FP x,y,z,t;
+} ECP_ext_ZZZ;
+
+/* r=k.a, where k=2d if a=-1 and k=d otherwise */
+static void ECP_ext_kmul(FP *r,FP *a)
+{
+    FP d;
+    if (ZZZ::CURVE_B_I==0)
+    {
+        FP_rcopy(&d,ZZZ::CURVE_B);
+        FP_mul(r,a,&d);
+    }
+    else
+        FP_imul(r,a,ZZZ::CURVE_B_I);
+    if (ZZZ::CURVE_A==-1)
+    {
+        FP_add(r,r,r);
+        FP_norm(r);
+    }
+}
+
+/* Set E=P in extended coordinates, as (XZ:YZ:Z^2:XY) */
+static void ECP_ext_from(ECP_ext_ZZZ *E,ZZZ::ECP *P)
+{
+    FP_mul(&(E->t),&(P->x),&(P->y));
+    FP_mul(&(E->x),&(P->x),&(P->z));
+    FP_mul(&(E->y),&(P->y),&(P->z));
+    FP_sqr(&(E->z),&(P->z));
+}
+
+/* Set P=E, dropping T */
+static void ECP_ext_to(ZZZ::ECP *P,ECP_ext_ZZZ *E)
+{
+    FP_copy(&(P->x),&(E->x));
+    FP_copy(&(P->y),&(E->y));
+    FP_copy(&(P->z),&(E->z));
+}
+
+/* Convert E to table form */
+static void ECP_ext_table(ECP_ext_ZZZ *E)
+{
+    FP s;
+    ECP_ext_kmul(&(E->t),&(E->t));
+    if (ZZZ::CURVE_A==-1)
+    {
+        FP_add(&s,&(E->y),&(E->x));
+        FP_norm(&s);
+        FP_sub(&(E->y),&(E->y),&(E->x));
+        FP_norm(&(E->y));
+        FP_copy(&(E->x),&s);
+        FP_add(&(E->z),&(E->z),&(E->z));
+        FP_norm(&(E->z));
+    }
+}
+
+/* Set P=Q */
+static void ECP_ext_copy(ECP_ext_ZZZ *P,ECP_ext_ZZZ *Q)
+{
+    FP_copy(&(P->x),&(Q->x));
+    FP_copy(&(P->y),&(Q->y));
+    FP_copy(&(P->z),&(Q->z));
+    FP_copy(&(P->t),&(Q->t));
+}
+
+/* Set P=O */
+static void ECP_ext_inf(ECP_ext_ZZZ *P)
+{
+    FP_zero(&(P->x));
+    FP_one(&(P->y));
+    FP_one(&(P->z));
+    FP_zero(&(P->t));
+}
+
+/* Set P=-P, where P is in table form */
+static void ECP_ext_neg(ECP_ext_ZZZ *P)
+{
+    if (ZZZ::CURVE_A==-1)
+        FP_cswap(&(P->x),&(P->y),1);
+    else
+    {
+        FP_neg(&(P->x),&(P->x));
+        FP_norm(&(P->x));
+    }
+    FP_neg(&(P->t),&(P->t));
+    FP_norm(&(P->t));
+}
+
+/* Conditional move Q to P dependant on d */
+static void ECP_ext_cmove(ECP_ext_ZZZ *P,ECP_ext_ZZZ *Q,int d)
+{
+    FP_cmove(&(P->x),&(Q->x),d);
+    FP_cmove(&(P->y),&(Q->y),d);
+    FP_cmove(&(P->z),&(Q->z),d);
+    FP_cmove(&(P->t),&(Q->t),d);
+}
+
+/* Constant time select from pre-computed table of n odd multiples */
+static void ECP_ext_select(ECP_ext_ZZZ *P,ECP_ext_ZZZ W[],sign32 b,int n)
+{
+    int i;
+    ECP_ext_ZZZ MP;
+    sign32 m=b>>31;
+    sign32 babs=(b^m)-m;
+
+    babs=(babs-1)/2;
+
+    for (i=0; i<n; i++)
+        ECP_ext_cmove(P,&W[i],teq(babs,i));  // conditional move
+
+    ECP_ext_copy(&MP,P);
+    ECP_ext_neg(&MP);  // minus P
+    ECP_ext_cmove(P,&MP,(int)(m&1));
+}
+
+/* Set P=2P. T is not used, and is only calculated if t is set - 4M+3S, or 5M+3S with T */
+/* If a=-1 the signs of F and H are swapped, which negates (X:Y:Z:T) and saves a negation */
+static void ECP_ext_dbl(ECP_ext_ZZZ *P,int t)
+{
+    FP A,B,C,E,F,G,H;
+
+    FP_sqr(&A,&(P->x));
+    FP_sqr(&B,&(P->y));
+    FP_sqr(&C,&(P->z));
+    FP_add(&C,&C,&C);
+    FP_mul(&E,&(P->x),&(P->y));
+    FP_add(&E,&E,&E);
+    FP_norm(&E);
+    if (ZZZ::CURVE_A==-1)
+    {
+        FP_sub(&G,&B,&A);
+        FP_norm(&G);
+        FP_sub(&F,&C,&G);
+        FP_add(&H,&A,&B);
+    }
+    else
+    {
+        FP_add(&G,&A,&B);
+        FP_norm(&G);
+        FP_sub(&F,&G,&C);
+        FP_sub(&H,&A,&B);
+    }
+    FP_norm(&F);
+    FP_norm(&H);
+
+    FP_mul(&(P->x),&E,&F);
+    FP_mul(&(P->y),&G,&H);
+    FP_mul(&(P->z),&F,&G);
+    if (t) FP_mul(&(P->t),&E,&H);
+}
+
+/* Set P+=Q, where Q is in table form. The formulae are unified and complete. T is only calculated if t is set */
+/* 7M for a=-1, 9M otherwise, plus 1M for T */
+static void ECP_ext_add(ECP_ext_ZZZ *P,ECP_ext_ZZZ *Q,int t)
+{
+    FP A,B,C,D,E,F,G,H;
+
+    if (ZZZ::CURVE_A==-1)
+    {
+        FP_sub(&A,&(P->y),&(P->x));
+        FP_norm(&A);
+        FP_mul(&A,&A,&(Q->y));
+        FP_add(&B,&(P->y),&(P->x));
+        FP_norm(&B);
+        FP_mul(&B,&B,&(Q->x));
+        FP_mul(&C,&(P->t),&(Q->t));
+        FP_mul(&D,&(P->z),&(Q->z));
+        FP_sub(&E,&B,&A);
+        FP_add(&H,&B,&A);
+    }
+    else
+    {
+        FP_mul(&A,&(P->x),&(Q->x));
+        FP_mul(&B,&(P->y),&(Q->y));
+        FP_mul(&C,&(P->t),&(Q->t));
+        FP_mul(&D,&(P->z),&(Q->z));
+        FP_add(&E,&(P->x),&(P->y));
+        FP_norm(&E);
+        FP_add(&F,&(Q->x),&(Q->y));
+        FP_norm(&F);
+        FP_mul(&E,&E,&F);
+        FP_sub(&E,&E,&A);
+        FP_sub(&E,&E,&B);
+        FP_sub(&H,&B,&A);
+    }
+    FP_norm(&E);
+    FP_norm(&H);
+    FP_sub(&F,&D,&C);
+    FP_norm(&F);
+    FP_add(&G,&D,&C);
+    FP_norm(&G);
+
+    FP_mul(&(P->x),&E,&F);
+    FP_mul(&(P->y),&G,&H);
+    FP_mul(&(P->z),&F,&G);
+    if (t) FP_mul(&(P->t),&E,&H);
+}
+
+#endif
+
 #if CURVETYPE_ZZZ!=MONTGOMERY
 /* constant time multiply by small integer of length bts - use ladder */
 void ZZZ::ECP_pinmul(ECP *P,int e,int bts)
@@ -969,9 +1449,183 @@ void ZZZ::ECP_pinmul(ECP *P,int e,int bts)
 }
 #endif
 
-/* Set P=r*P */
+#ifdef USE_GLV_ECP_ZZZ
+
+/* GLV method. Split e.P as u[0].A+u[1].B, where A=P and B=(Beta.x,y)=lambda.P, up to sign, and u[0], u[1] are about half the length of the group order */
+static void ECP_glv(ZZZ::ECP *A,ZZZ::ECP *B,BIG u[2],ZZZ::ECP *P,BIG e)
+{
+    int i,j,s;
+    BIG v[2],t,q,ee;
+    DBIG d;
+    FP cru;
+    ZZZ::ECP N;
+
+    BIG_rcopy(q,ZZZ::CURVE_Order);
+    BIG_copy(ee,e);
+    BIG_mod(ee,q);
+    for (i=0; i<2; i++)
+    {
+        BIG_rcopy(t,ZZZ::CURVE_W[i]);
+        BIG_mul(d,t,ee);
+        BIG_ddiv(v[i],d,q);
+        BIG_zero(u[i]);
+    }
+    BIG_copy(u[0],ee);
+    for (i=0; i<2; i++)
+        for (j=0; j<2; j++)
+        {
+            BIG_rcopy(t,ZZZ::CURVE_SB[j][i]);
+            BIG_modmul(t,v[j],t,q);
+            BIG_add(u[i],u[i],q);
+            BIG_sub(u[i],u[i],t);
+            BIG_mod(u[i],q);
+        }
+
+    ZZZ::ECP_copy(B,P);
+    FP_rcopy(&cru,ZZZ::CURVE_Cru);
+    FP_mul(&(B->x),&(B->x),&cru);
+    ZZZ::ECP_copy(A,P);
+
+    /* note that -a.B = a.(-B). Use a or -a depending on which is smaller */
+    for (i=0; i<2; i++)
+    {
+        BIG_modneg(t,u[i],q);
+        s=(BIG_nbits(t)<BIG_nbits(u[i]));
+        BIG_cmove(u[i],t,s);
+        BIG_norm(u[i]);
+        ZZZ::ECP_copy(&N,(i==0)?A:B);
+        ZZZ::ECP_neg(&N);
+        ECP_cmove((i==0)?A:B,&N,s);
+    }
+}
+
+/* Set P=u[0].Q[0]+u[1].Q[1]+u[2].Q[2]+u[3].Q[3], constant time, as ECP2_mul4 */
+static void ECP_mul4(ZZZ::ECP *P,ZZZ::ECP Q[4],BIG u[4])
+{
+    int i,j,k,nb,pb,bt;
+    ZZZ::ECP T[8],W;
+    BIG t[4],mt;
+    sign8 w[NLEN_XXX*BASEBITS_XXX+1];
+    sign8 s[NLEN_XXX*BASEBITS_XXX+1];
+
+    for (i=0; i<4; i++)
+    {
+        BIG_copy(t[i],u[i]);
+    }
+
+// Precomputed table
+    ZZZ::ECP_copy(&T[0],&Q[0]); // Q[0]
+    ZZZ::ECP_copy(&T[1],&T[0]);
+    ZZZ::ECP_add(&T[1],&Q[1]);  // Q[0]+Q[1]
+    ZZZ::ECP_copy(&T[2],&T[0]);
+    ZZZ::ECP_add(&T[2],&Q[2]);  // Q[0]+Q[2]
+    ZZZ::ECP_copy(&T[3],&T[1]);
+    ZZZ::ECP_add(&T[3],&Q[2]);  // Q[0]+Q[1]+Q[2]
+    ZZZ::ECP_copy(&T[4],&T[0]);
+    ZZZ::ECP_add(&T[4],&Q[3]);  // Q[0]+Q[3]
+    ZZZ::ECP_copy(&T[5],&T[1]);
+    ZZZ::ECP_add(&T[5],&Q[3]);  // Q[0]+Q[1]+Q[3]
+    ZZZ::ECP_copy(&T[6],&T[2]);
+    ZZZ::ECP_add(&T[6],&Q[3]);  // Q[0]+Q[2]+Q[3]
+    ZZZ::ECP_copy(&T[7],&T[3]);
+    ZZZ::ECP_add(&T[7],&Q[3]);  // Q[0]+Q[1]+Q[2]+Q[3]
+
+// Make it odd
+    pb=1-BIG_parity(t[0]);
+    BIG_inc(t[0],pb);
+    BIG_norm(t[0]);
+
+// Number of bits
+    BIG_zero(mt);
+    for (i=0; i<4; i++)
+    {
+        BIG_or(mt,mt,t[i]);
+    }
+    nb=1+BIG_nbits(mt);
+
+// Sign pivot
+    s[nb-1]=1;
+    for (i=0; i<nb-1; i++)
+    {
+        BIG_fshr(t[0],1);
+        s[i]=2*BIG_parity(t[0])-1;
+    }
+
+// Recoded exponent
+    for (i=0; i<nb; i++)
+    {
+        w[i]=0;
+        k=1;
+        for (j=1; j<4; j++)
+        {
+            bt=s[i]*BIG_parity(t[j]);
+            BIG_fshr(t[j],1);
+
+            BIG_dec(t[j],(bt>>1));
+            BIG_norm(t[j]);
+            w[i]+=bt*k;
+            k*=2;
+        }
+    }
+
+// Main loop
+    ECP_select(P,T,2*w[nb-1]+1,8);
+    for (i=nb-2; i>=0; i--)
+    {
+        ECP_select(&W,T,2*w[i]+s[i],8);
+        ZZZ::ECP_dbl(P);
+        ZZZ::ECP_add(P,&W);
+    }
+
+// apply correction
+    ZZZ::ECP_copy(&W,P);
+    ZZZ::ECP_sub(&W,&Q[0]);
+    ECP_cmove(P,&W,pb);
+}
+
+#endif
+
+#if CURVETYPE_ZZZ==MONTGOMERY
+/* Merged Montgomery ladder step. Set Q=P+Q and P=2P, where u is the affine x-coordinate of Q-P */
+/* 5M+4S, and a multiplication by the small constant a24=(A+2)/4 */
+static void ECP_ladder_step(ZZZ::ECP *P,ZZZ::ECP *Q,FP *u)
+{
+    FP A,B,C,D,E,AA,BB,DA,CB;
+
+    FP_add(&A,&(P->x),&(P->z));
+    FP_norm(&A);
+    FP_sub(&B,&(P->x),&(P->z));
+    FP_norm(&B);
+    FP_add(&C,&(Q->x),&(Q->z));
+    FP_norm(&C);
+    FP_sub(&D,&(Q->x),&(Q->z));
+    FP_norm(&D);
+
+    FP_mul(&DA,&D,&A);
+    FP_mul(&CB,&C,&B);
+    FP_add(&C,&DA,&CB);
+    FP_norm(&C);
+    FP_sqr(&(Q->x),&C);
+    FP_sub(&D,&DA,&CB);
+    FP_norm(&D);
+    FP_sqr(&D,&D);
+    FP_mul(&(Q->z),u,&D);
+
+    FP_sqr(&AA,&A);
+    FP_sqr(&BB,&B);
+    FP_sub(&E,&AA,&BB);
+    FP_norm(&E);
+    FP_mul(&(P->x),&AA,&BB);
+    FP_imul(&A,&E,(ZZZ::CURVE_A+2)/4);
+    FP_add(&BB,&BB,&A);
+    FP_norm(&BB);
+    FP_mul(&(P->z),&BB,&E);
+}
+#endif
+
+/* Set P=r*P, leaving P in projective coordinates */
 /* SU=424 */
-void ZZZ::ECP_mul(ECP *P,BIG e)
+void ZZZ::ECP_mul_proj(ECP *P,BIG e)
 {
 #if CURVETYPE_ZZZ==MONTGOMERY
     /* Montgomery ladder */
@@ -994,23 +1648,96 @@ void ZZZ::ECP_mul(ECP *P,BIG e)
     for (i=nb-2; i>=0; i--)
     {
         b=BIG_bit(e,i);
-        ECP_copy(P,&R1);
-        ECP_add(P,&R0,&D);
         ECP_cswap(&R0,&R1,b);
-        ECP_copy(&R1,P);
-        ECP_dbl(&R0);
-
+        ECP_ladder_step(&R0,&R1,&(D.x));
         ECP_cswap(&R0,&R1,b);
     }
 
     ECP_copy(P,&R0);
 
+#elif defined(USE_GLV_ECP_ZZZ)
+    /* GLV - joint double multiplication with half length multipliers */
+    ECP Q;
+    BIG u[2];
+    ECP_glv(P,&Q,u,P,e);
+    ECP_mul2_window(P,&Q,u[0],u[1]);
+
+#elif CURVETYPE_ZZZ==EDWARDS
+    /* fixed size windows, in extended coordinates */
+    int i,j,nb,s,ns;
+    BIG mt,t;
+    ECP_ext_ZZZ R,Q,W[1<<(MUL_WINDOW_ZZZ-1)],C;
+    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ];
+
+    if (ECP_isinf(P)) return;
+    if (BIG_iszilch(e))
+    {
+        ECP_inf(P);
+        return;
+    }
+
+    /* precompute table, in table form */
+
+    ECP_ext_from(&R,P);
+    ECP_ext_copy(&Q,&R);
+    ECP_ext_dbl(&Q,1);
+    ECP_ext_table(&Q);
+
+    ECP_ext_copy(&W[0],&R);
+    ECP_ext_table(&W[0]);
+
+    for (i=1; i<(1<<(MUL_WINDOW_ZZZ-1)); i++)
+    {
+        ECP_ext_add(&R,&Q,1);
+        ECP_ext_copy(&W[i],&R);
+        ECP_ext_table(&W[i]);
+    }
+
+    /* make exponent odd - add 2P if even, P if odd */
+    BIG_copy(t,e);
+    s=BIG_parity(t);
+    BIG_inc(t,1);
+    BIG_norm(t);
+    ns=BIG_parity(t);
+    BIG_copy(mt,t);
+    BIG_inc(mt,1);
+    BIG_norm(mt);
+    BIG_cmove(t,mt,s);
+    ECP_ext_cmove(&Q,&W[0],ns);
+    ECP_ext_copy(&C,&Q);
+    ECP_ext_neg(&C);
+
+    nb=1+(BIG_nbits(t)+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ;
+
+    /* convert exponent to signed MUL_WINDOW_ZZZ-bit window */
+    for (i=0; i<nb; i++)
+    {
+        w[i]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1)-(1<<MUL_WINDOW_ZZZ);
+        BIG_dec(t,w[i]);
+        BIG_norm(t);
+        BIG_fshr(t,MUL_WINDOW_ZZZ);
+    }
+    w[nb]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1);
+
+    /* T is only needed ahead of an addition */
+    ECP_ext_inf(&R);
+    ECP_ext_add(&R,&W[(w[nb]-1)/2],0);
+    for (i=nb-1; i>=0; i--)
+    {
+        ECP_ext_select(&Q,W,w[i],1<<(MUL_WINDOW_ZZZ-1));
+        for (j=0; j<MUL_WINDOW_ZZZ; j++)
+            ECP_ext_dbl(&R,j==MUL_WINDOW_ZZZ-1);
+        ECP_ext_add(&R,&Q,i==0);
+    }
+    ECP_ext_add(&R,&C,0); /* apply correction */
+    ECP_ext_to(P,&R);
+
 #else
     /* fixed size windows */
-    int i,nb,s,ns;
+    int i,j,nb,s,ns;
     BIG mt,t;
-    ECP Q,W[8],C;
-    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+3)/4];
+    ECP Q,W[1<<(MUL_WINDOW_ZZZ-1)],C;
+    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ];
 
     if (ECP_isinf(P)) return;
     if (BIG_iszilch(e))
@@ -1026,7 +1753,7 @@ void ZZZ::ECP_mul(ECP *P,BIG e)
 
     ECP_copy(&W[0],P);
 
-    for (i=1; i<8; i++)
+    for (i=1; i<(1<<(MUL_WINDOW_ZZZ-1)); i++)
     {
         ECP_copy(&W[i],&W[i-1]);
         ECP_add(&W[i],&Q);
@@ -1045,39 +1772,343 @@ void ZZZ::ECP_mul(ECP *P,BIG e)
     ECP_cmove(&Q,P,ns);
     ECP_copy(&C,&Q);
 
-    nb=1+(BIG_nbits(t)+3)/4;
+    nb=1+(BIG_nbits(t)+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ;
 
-    /* convert exponent to signed 4-bit window */
+    /* convert exponent to signed MUL_WINDOW_ZZZ-bit window */
     for (i=0; i<nb; i++)
     {
-        w[i]=BIG_lastbits(t,5)-16;
+        w[i]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1)-(1<<MUL_WINDOW_ZZZ);
         BIG_dec(t,w[i]);
         BIG_norm(t);
-        BIG_fshr(t,4);
+        BIG_fshr(t,MUL_WINDOW_ZZZ);
     }
-    w[nb]=BIG_lastbits(t,5);
+    w[nb]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1);
 
     ECP_copy(P,&W[(w[nb]-1)/2]);
     for (i=nb-1; i>=0; i--)
     {
-        ECP_select(&Q,W,w[i]);
-        ECP_dbl(P);
-        ECP_dbl(P);
-        ECP_dbl(P);
-        ECP_dbl(P);
+        ECP_select(&Q,W,w[i],1<<(MUL_WINDOW_ZZZ-1));
+        for (j=0; j<MUL_WINDOW_ZZZ; j++)
+            ECP_dbl(P);
         ECP_add(P,&Q);
     }
     ECP_sub(P,&C); /* apply correction */
 #endif
+}
+
+/* Set P=r*P */
+void ZZZ::ECP_mul(ECP *P,BIG e)
+{
+    ECP_mul_proj(P,e);
     ECP_affine(P);
 }
 
+#if CURVETYPE_ZZZ==MONTGOMERY
+/* x-only ladder, as in RFC 7748. Set r=x(k.P), where u=x(P) */
+/* Runs over a fixed MODBITS_YYY bits of k, and ends with a single constant time inversion, so timing is independent of k and u */
+void ZZZ::ECP_ladder(BIG r,BIG k,BIG u)
+{
+    int i,b,swap;
+    BIG m;
+    FP x1,t;
+    ECP R0,R1;
+
+    BIG_rcopy(m,Modulus);
+    BIG_copy(r,u);
+    BIG_mod(r,m);
+    FP_nres(&x1,r);
+
+    FP_one(&(R0.x));
+    FP_zero(&(R0.z));
+    FP_copy(&(R1.x),&x1);
+    FP_one(&(R1.z));
+
+    swap=0;
+    for (i=MODBITS_YYY-1; i>=0; i--)
+    {
+        b=BIG_bit(k,i);
+        swap^=b;
+        ECP_cswap(&R0,&R1,swap);
+        swap=b;
+        ECP_ladder_step(&R0,&R1,&x1);
+    }
+    ECP_cswap(&R0,&R1,swap);
+
+    FP_inv(&t,&(R0.z));
+    FP_mul(&(R0.x),&(R0.x),&t);
+    FP_reduce(&(R0.x));
+    FP_redc(r,&(R0.x));
+}
+#endif
+
 #if CURVETYPE_ZZZ!=MONTGOMERY
-/* Set P=eP+fQ double multiplication */
+
+/* run length of the comb tables built by ECP_precomp_init, which cover the full width of a BIG */
+#define PRECOMP_LEN ((NLEN_XXX*BASEBITS_XXX+PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ-1)/(PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ))
+
+#if CURVETYPE_ZZZ==EDWARDS
+/* Set T->E from the affine entries of T->W, for extended coordinate addition */
+static void ECP_comb_ext(ZZZ::ECP_precomp *T)
+{
+    int i,j;
+    ECP_ext_ZZZ E;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+        for (i=0; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            ECP_ext_from(&E,&(T->W[j][i]));
+            ECP_ext_table(&E);
+            FP_copy(&(T->E[j][i][0]),&(E.x));
+            FP_copy(&(T->E[j][i][1]),&(E.y));
+            FP_copy(&(T->E[j][i][2]),&(E.t));
+        }
+}
+#endif
+
+/* Build fixed base comb tables for Q, with runs of len bits. The multiplier is split into PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ runs */
+/* W[j][i] is the sum of 2^((k*PRECOMP_BLOCKS_ZZZ+j)*len).Q over the set bits k of i */
+static void ECP_comb_init(ZZZ::ECP_precomp *T,ZZZ::ECP *Q,int len)
+{
+    int i,j,k;
+    ZZZ::ECP B[PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ];
+
+    ZZZ::ECP_copy(&B[0],Q);
+    for (i=1; i<PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ; i++)
+    {
+        ZZZ::ECP_copy(&B[i],&B[i-1]);
+        for (k=0; k<len; k++) ZZZ::ECP_dbl(&B[i]);
+    }
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ZZZ::ECP_inf(&(T->W[j][0]));
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            for (k=0; ((i>>k)&1)==0; k++) ;
+            ZZZ::ECP_copy(&(T->W[j][i]),&(T->W[j][i&(i-1)]));
+            ZZZ::ECP_add(&(T->W[j][i]),&B[k*PRECOMP_BLOCKS_ZZZ+j]);
+        }
+        ZZZ::ECP_affine_batch(T->W[j],1<<PRECOMP_WINDOW_ZZZ);
+    }
+#if CURVETYPE_ZZZ==EDWARDS
+    ECP_comb_ext(T);
+#endif
+}
+
+/* Build comb tables for the generator, for multipliers less than the group order. The run length is returned */
+static int ECP_comb_gen(ZZZ::ECP_precomp *T)
+{
+    int len;
+    BIG r;
+    ZZZ::ECP G;
+    BIG_rcopy(r,ZZZ::CURVE_Order);
+    len=(BIG_nbits(r)+PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ-1)/(PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ);
+    ZZZ::ECP_generator(&G);
+    ECP_comb_init(T,&G,len);
+    return len;
+}
+
+/* Bits of t which select from comb table j, for column i */
+static sign32 ECP_comb_bits(BIG t,int len,int i,int j)
+{
+    int k,m;
+    sign32 b=0;
+    for (k=0; k<PRECOMP_WINDOW_ZZZ; k++)
+    {
+        m=(k*PRECOMP_BLOCKS_ZZZ+j)*len+i;
+        if (m<NLEN_XXX*BASEBITS_XXX) b|=BIG_bit(t,m)<<k;
+    }
+    return b;
+}
+
+#if CURVETYPE_ZZZ==EDWARDS
+/* Constant time select entry b of comb table j, in extended coordinate table form */
+static void ECP_comb_select(ECP_ext_ZZZ *P,ZZZ::ECP_precomp *T,int j,sign32 b)
+{
+    int i,d;
+    for (i=0; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+    {
+        d=teq(b,i);
+        FP_cmove(&(P->x),&(T->E[j][i][0]),d);
+        FP_cmove(&(P->y),&(T->E[j][i][1]),d);
+        FP_cmove(&(P->t),&(T->E[j][i][2]),d);
+    }
+    FP_one(&(P->z));
+    if (ZZZ::CURVE_A==-1)
+        FP_add(&(P->z),&(P->z),&(P->z));
+}
+
+/* Add column i of the comb tables, as selected by the bits of t. W[j][0] is the identity, which the unified addition handles */
+static void ECP_comb_add(ECP_ext_ZZZ *P,ZZZ::ECP_precomp *T,BIG t,int len,int i)
+{
+    int j;
+    ECP_ext_ZZZ Q;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ECP_comb_select(&Q,T,j,ECP_comb_bits(t,len,i,j));
+        ECP_ext_add(P,&Q,1);
+    }
+}
+
+/* Set P=t.Q+f.R, where T and U are the comb tables of Q and R, with runs of len bits. U may be NULL. Extended coordinates are used throughout */
+static void ECP_comb_mul(ZZZ::ECP *P,ZZZ::ECP_precomp *T,BIG t,ZZZ::ECP_precomp *U,BIG f,int len)
+{
+    int i;
+    ECP_ext_ZZZ R;
+    ECP_ext_inf(&R);
+    for (i=len-1; i>=0; i--)
+    {
+        ECP_ext_dbl(&R,1);
+        ECP_comb_add(&R,T,t,len,i);
+        if (U!=NULL) ECP_comb_add(&R,U,f,len,i);
+    }
+    ECP_ext_to(P,&R);
+}
+#else
+/* Constant time select W[b] from comb table */
+static void ECP_comb_select(ZZZ::ECP *P,ZZZ::ECP W[],sign32 b)
+{
+    int i;
+    for (i=0; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        ECP_cmove(P,&W[i],teq(b,i));
+}
+
+/* Add column i of the comb tables, as selected by the bits of t */
+/* Table entries are affine, so mixed addition is used. Any infinite entry, such as W[j][0] or every entry when Q is infinity, is masked out */
+static void ECP_comb_add(ZZZ::ECP *P,ZZZ::ECP_precomp *T,BIG t,int len,int i)
+{
+    int j;
+    sign32 b;
+    ZZZ::ECP Q,R;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        b=ECP_comb_bits(t,len,i,j);
+        ECP_comb_select(&Q,T->W[j],b);
+        ZZZ::ECP_copy(&R,P);
+        ECP_addaff(&R,&Q);
+        ECP_cmove(P,&R,1-(teq(b,0)|ZZZ::ECP_isinf(&Q)));
+    }
+}
+
+/* Set P=t.Q+f.R, where T and U are the comb tables of Q and R, with runs of len bits. U may be NULL */
+static void ECP_comb_mul(ZZZ::ECP *P,ZZZ::ECP_precomp *T,BIG t,ZZZ::ECP_precomp *U,BIG f,int len)
+{
+    int i;
+    ZZZ::ECP_inf(P);
+    for (i=len-1; i>=0; i--)
+    {
+        ZZZ::ECP_dbl(P);
+        ECP_comb_add(P,T,t,len,i);
+        if (U!=NULL) ECP_comb_add(P,U,f,len,i);
+    }
+}
+#endif
+#endif
+
+/* Set P=e*G, where G is the generator */
+void ZZZ::ECP_mul_gen(ECP *P,BIG e)
+{
+#if CURVETYPE_ZZZ==MONTGOMERY
+    ECP_generator(P);
+    ECP_mul(P,e);
+#else
+    /* Lim-Lee fixed base comb. The table is built on first use - static initialisation is thread safe */
+    static ECP_precomp T;
+    static const int len=ECP_comb_gen(&T);
+    BIG r,t;
+
+    BIG_rcopy(r,CURVE_Order);
+    BIG_copy(t,e);
+    BIG_norm(t);
+    BIG_mod(t,r);
+
+    ECP_comb_mul(P,&T,t,NULL,NULL,len);
+#endif
+    ECP_affine(P);
+}
+
+#if CURVETYPE_ZZZ!=MONTGOMERY
+/* Build comb tables for P, for multipliers which fill a BIG */
+void ZZZ::ECP_precomp_init(ECP_precomp *T,ECP *P)
+{
+    ECP_comb_init(T,P,PRECOMP_LEN);
+}
+
+/* Output table to octet string, as the uncompressed encodings of its entries. The first entry of each table is the point at infinity, and is omitted */
+void ZZZ::ECP_precomp_toOctet(octet *S,ECP_precomp *T)
+{
+    int i,j;
+    octet E;
+    S->len=0;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            E.len=0;
+            E.max=2*MODBYTES_XXX+1;
+            E.val=&(S->val[S->len]);
+            ECP_toOctet(&E,&(T->W[j][i]),false);
+            S->len+=E.len;
+        }
+}
+
+/* Restore table from octet string. Returns 0 if any entry is not on the curve */
+int ZZZ::ECP_precomp_fromOctet(ECP_precomp *T,octet *S)
+{
+    int i,j;
+    octet E;
+    if (S->len!=PRECOMP_BLOCKS_ZZZ*((1<<PRECOMP_WINDOW_ZZZ)-1)*(2*MODBYTES_XXX+1)) return 0;
+    E.len=E.max=2*MODBYTES_XXX+1;
+    E.val=S->val;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ECP_inf(&(T->W[j][0]));
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            if (E.val[0]!=0x04 || !ECP_fromOctet(&(T->W[j][i]),&E)) return 0;
+            E.val+=E.len;
+        }
+    }
+#if CURVETYPE_ZZZ==EDWARDS
+    ECP_comb_ext(T);
+#endif
+    return 1;
+}
+
+/* Set P=e.Q, where T was built from Q by ECP_precomp_init */
+void ZZZ::ECP_mul_precomp(ECP *P,ECP_precomp *T,BIG e)
+{
+    BIG t;
+
+    BIG_copy(t,e);
+    BIG_norm(t);
+
+    ECP_comb_mul(P,T,t,NULL,NULL,PRECOMP_LEN);
+    ECP_affine(P);
+}
+
+/* Set P=e.Q+f.R, where T and U were built from Q and R by ECP_precomp_init */
+void ZZZ::ECP_mul2_precomp(ECP *P,ECP_precomp *T,BIG e,ECP_precomp *U,BIG f)
+{
+    BIG te,tf;
+
+    BIG_copy(te,e);
+    BIG_norm(te);
+    BIG_copy(tf,f);
+    BIG_norm(tf);
+
+    ECP_comb_mul(P,T,te,U,tf,PRECOMP_LEN);
+    ECP_affine(P);
+}
+#endif
+
+#if CURVETYPE_ZZZ!=MONTGOMERY
+/* Set P=eP+fQ double multiplication, leaving P in projective coordinates */
 /* constant time - as useful for GLV method in pairings */
 /* SU=456 */
 
-void ZZZ::ECP_mul2(ECP *P,ECP *Q,BIG e,BIG f)
+#ifdef USE_GLV_ECP_ZZZ
+static void ZZZ::ECP_mul2_window(ECP *P,ECP *Q,BIG e,BIG f)
+#else
+void ZZZ::ECP_mul2_proj(ECP *P,ECP *Q,BIG e,BIG f)
+#endif
 {
     BIG te,tf,mt;
     ECP S,T,W[8],C;
@@ -1152,18 +2183,334 @@ void ZZZ::ECP_mul2(ECP *P,ECP *Q,BIG e,BIG f)
     }
     w[nb]=(4*BIG_lastbits(te,3)+BIG_lastbits(tf,3));
 
+#if CURVETYPE_ZZZ==EDWARDS
+    /* main loop in extended coordinates, with the table in table form */
+    ECP_ext_ZZZ R,E,X[8],D;
+    for (i=0; i<8; i++)
+    {
+        ECP_ext_from(&X[i],&W[i]);
+        ECP_ext_table(&X[i]);
+    }
+    ECP_ext_from(&D,&C);
+    ECP_ext_table(&D);
+    ECP_ext_neg(&D);
+
+    ECP_ext_inf(&R);
+    ECP_ext_add(&R,&X[(w[nb]-1)/2],0);
+    for (i=nb-1; i>=0; i--)
+    {
+        ECP_ext_select(&E,X,w[i],8);
+        ECP_ext_dbl(&R,0);
+        ECP_ext_dbl(&R,1);
+        ECP_ext_add(&R,&E,i==0);
+    }
+    ECP_ext_add(&R,&D,0); /* apply correction */
+    ECP_ext_to(P,&R);
+#else
     ECP_copy(P,&W[(w[nb]-1)/2]);
     for (i=nb-1; i>=0; i--)
     {
-        ECP_select(&T,W,w[i]);
+        ECP_select(&T,W,w[i],8);
         ECP_dbl(P);
         ECP_dbl(P);
         ECP_add(P,&T);
     }
     ECP_sub(P,&C); /* apply correction */
+#endif
+}
+
+#ifdef USE_GLV_ECP_ZZZ
+/* GLV splits e and f, so P=eP+fQ is a quadruple multiplication with half length multipliers */
+void ZZZ::ECP_mul2_proj(ECP *P,ECP *Q,BIG e,BIG f)
+{
+    ECP W[4];
+    BIG u[4];
+    ECP_glv(&W[0],&W[1],u,P,e);
+    ECP_glv(&W[2],&W[3],&u[2],Q,f);
+    ECP_mul4(P,W,u);
+}
+#endif
+
+/* Set P=eP+fQ double multiplication */
+void ZZZ::ECP_mul2(ECP *P,ECP *Q,BIG e,BIG f)
+{
+    ECP_mul2_proj(P,Q,e,f);
     ECP_affine(P);
 }
 
+#define MULN_STRAUS 16 /* Straus for up to this many points, Pippenger buckets for more */
+#define MULN_MAXWIN 8 /* largest Pippenger window, which bounds the number of buckets */
+
+/* test for affine form Z=1 */
+static int ECP_isaff(ZZZ::ECP *P)
+{
+    YYY::FP one;
+    FP_one(&one);
+    return FP_equals(&(P->z),&one);
+}
+
+/* Set P+=Q or P-=Q as s is 0 or 1, with mixed addition if Q is affine - not constant time */
+static void ECP_addsign(ZZZ::ECP *P,ZZZ::ECP *Q,int s)
+{
+    ZZZ::ECP NQ;
+    ZZZ::ECP_copy(&NQ,Q);
+    if (s) ZZZ::ECP_neg(&NQ);
+    if (ECP_isaff(&NQ)) ECP_addaff(P,&NQ);
+    else ZZZ::ECP_add(P,&NQ);
+}
+
+/* Number of signed c bit digits for multipliers of mb bits. The top digit keeps a spare bit so that k+H below does not overflow */
+static int ECP_muln_digits(int mb,int c)
+{
+    return (mb+c+1)/c;
+}
+
+/* Set kh=k+H, where H has bit c-1 of each of nw windows set. Digit i of k is then window i of kh less 2^(c-1) */
+static void ECP_muln_offset(BIG kh,BIG k,BIG h)
+{
+    BIG_copy(kh,k);
+    BIG_norm(kh);
+    BIG_add(kh,kh,h);
+    BIG_norm(kh);
+}
+
+/* H for nw windows of c bits */
+static void ECP_muln_h(BIG h,int c,int nw)
+{
+    int i;
+    BIG_zero(h);
+    for (i=0; i<nw; i++)
+    {
+        BIG_shl(h,c);
+        BIG_inc(h,1<<(c-1));
+    }
+}
+
+/* Signed digit i, in the range -2^(c-1) to 2^(c-1)-1 */
+static int ECP_muln_digit(BIG kh,int i,int c)
+{
+    int j,d=0;
+    for (j=c-1; j>=0; j--)
+        d=2*d+BIG_bit(kh,c*i+j);
+    return d-(1<<(c-1));
+}
+
+/* R+=k[0].P[0]+...+k[n-1].P[n-1] by Straus with signed 4 bit windows, for n<=MULN_STRAUS and multipliers of mb bits */
+NOINLINE
+static void ECP_muln_straus(ZZZ::ECP *R,ZZZ::ECP *P,BIG *k,int n,int mb)
+{
+    int i,j,c,nw,d,s;
+    ZZZ::ECP T[MULN_STRAUS][8];
+    BIG K[MULN_STRAUS],h;
+
+    c=4;
+    nw=ECP_muln_digits(mb,c);
+    ECP_muln_h(h,c,nw);
+    for (j=0; j<n; j++)
+    {
+        ECP_muln_offset(K[j],k[j],h);
+        ZZZ::ECP_copy(&T[j][0],&P[j]);
+        ZZZ::ECP_copy(&T[j][1],&P[j]);
+        ZZZ::ECP_dbl(&T[j][1]);
+        for (i=2; i<8; i++)
+        {
+            ZZZ::ECP_copy(&T[j][i],&T[j][i-1]);
+            ZZZ::ECP_add(&T[j][i],&P[j]);
+        }
+    }
+    ZZZ::ECP_affine_batch(&T[0][0],8*n);
+    for (i=nw-1; i>=0; i--)
+    {
+        for (j=0; j<c; j++) ZZZ::ECP_dbl(R);
+        for (j=0; j<n; j++)
+        {
+            d=ECP_muln_digit(K[j],i,c);
+            if (d==0) continue;
+            s=(d<0);
+            if (s) d=-d;
+            ECP_addsign(R,&T[j][d-1],s);
+        }
+    }
+}
+
+/* R+=k[0].P[0]+...+k[n-1].P[n-1] by Pippenger buckets, with the window size chosen for n and multipliers of mb bits */
+NOINLINE
+static void ECP_muln_pippenger(ZZZ::ECP *R,ZZZ::ECP *P,BIG *k,int n,int mb)
+{
+    int i,j,c,nw,nb,d,s,cost,best,fs,fq;
+    ZZZ::ECP B[1<<(MULN_MAXWIN-1)],S,Q;
+    char full[1<<(MULN_MAXWIN-1)];
+    BIG kh,h;
+
+    /* choose the window minimising the number of additions */
+    c=0;
+    best=0;
+    for (i=2; i<=MULN_MAXWIN; i++)
+    {
+        nw=ECP_muln_digits(mb,i);
+        cost=nw*(n+(1<<i)+i);
+        if (c==0 || cost<best)
+        {
+            c=i;
+            best=cost;
+        }
+    }
+    nw=ECP_muln_digits(mb,c);
+    nb=1<<(c-1);
+    ECP_muln_h(h,c,nw);
+
+    for (i=nw-1; i>=0; i--)
+    {
+        for (j=0; j<c; j++) ZZZ::ECP_dbl(R);
+
+        /* fill buckets */
+        for (j=0; j<nb; j++) full[j]=0;
+        for (j=0; j<n; j++)
+        {
+            ECP_muln_offset(kh,k[j],h);
+            d=ECP_muln_digit(kh,i,c);
+            if (d==0) continue;
+            s=(d<0);
+            if (s) d=-d;
+            if (full[d-1])
+                ECP_addsign(&B[d-1],&P[j],s);
+            else
+            {
+                ZZZ::ECP_copy(&B[d-1],&P[j]);
+                if (s) ZZZ::ECP_neg(&B[d-1]);
+                full[d-1]=1;
+            }
+        }
+
+        /* sum of (j+1).B[j] as a sum of running sums */
+        fs=fq=0;
+        for (j=nb-1; j>=0; j--)
+        {
+            if (full[j])
+            {
+                if (fq) ZZZ::ECP_add(&Q,&B[j]);
+                else ZZZ::ECP_copy(&Q,&B[j]);
+                fq=1;
+            }
+            if (fq)
+            {
+                if (fs) ZZZ::ECP_add(&S,&Q);
+                else ZZZ::ECP_copy(&S,&Q);
+                fs=1;
+            }
+        }
+        if (fs) ZZZ::ECP_add(R,&S);
+    }
+}
+
+/* Set R=k[0].P[0]+k[1].P[1]+...+k[n-1].P[n-1] */
+/* Straus for small n, else Pippenger buckets. Each has its own function, so that only its own tables are on the stack */
+void ZZZ::ECP_muln(ECP *R,ECP *P,BIG *k,int n)
+{
+    int j,mb;
+    BIG kh;
+
+    ECP_inf(R);
+    if (n<=0) return;
+    mb=0;
+    for (j=0; j<n; j++)
+    {
+        BIG_copy(kh,k[j]);
+        BIG_norm(kh);
+        if (BIG_nbits(kh)>mb) mb=BIG_nbits(kh);
+    }
+    if (mb==0) return;
+
+    if (mb+MULN_MAXWIN+1>NLEN_XXX*BASEBITS_XXX)
+    {
+        /* no room in a BIG for the digit offsets - multiply one at a time */
+        ECP Q;
+        for (j=0; j<n; j++)
+        {
+            ECP_copy(&Q,&P[j]);
+            ECP_mul_proj(&Q,k[j]);
+            ECP_add(R,&Q);
+        }
+        ECP_affine(R);
+        return;
+    }
+
+    if (n<=MULN_STRAUS) ECP_muln_straus(R,P,k,n,mb);
+    else ECP_muln_pippenger(R,P,k,n,mb);
+    ECP_affine(R);
+}
+
+#define MULN_THREADS 64 /* most threads used by ECP_muln_mt */
+
+#ifdef THREADS
+
+/* one slice of the terms of ECP_muln_mt */
+typedef struct
+{
+    ZZZ::ECP R;
+    ZZZ::ECP *P;
+    BIG *k;
+    int n;
+} ECP_muln_job_ZZZ;
+
+static void *ECP_muln_worker(void *arg)
+{
+    ECP_muln_job_ZZZ *J=(ECP_muln_job_ZZZ *)arg;
+    ZZZ::ECP_muln(&(J->R),J->P,J->k,J->n);
+    return NULL;
+}
+
+#endif
+
+/* Set R=k[0].P[0]+k[1].P[1]+...+k[n-1].P[n-1] */
+/* The terms are split into nt slices of consecutive terms, each summed by ECP_muln in its own thread. The slice sums are added in order */
+void ZZZ::ECP_muln_mt(ECP *R,ECP *P,BIG *k,int n,int nt)
+{
+#ifdef THREADS
+    int i,m,done;
+    pthread_t id[MULN_THREADS];
+    char run[MULN_THREADS];
+    ECP_muln_job_ZZZ J[MULN_THREADS];
+    pthread_attr_t attr;
+
+    if (nt>MULN_THREADS) nt=MULN_THREADS;
+    if (nt>n/(MULN_STRAUS+1)) nt=n/(MULN_STRAUS+1); /* keep slices big enough for buckets */
+    if (nt>1)
+    {
+        /* room for the buckets, which are on the stack */
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr,sizeof(ECP)*((1<<(MULN_MAXWIN-1))+8*MULN_STRAUS)+(1<<18));
+        done=0;
+        for (i=0; i<nt; i++)
+        {
+            m=(n-done)/(nt-i);
+            J[i].P=&P[done];
+            J[i].k=&k[done];
+            J[i].n=m;
+            done+=m;
+            run[i]=0;
+            if (i<nt-1) run[i]=(pthread_create(&id[i],&attr,ECP_muln_worker,&J[i])==0);
+        }
+        pthread_attr_destroy(&attr);
+
+        /* last slice, and any that did not get a thread, in this thread */
+        ECP_inf(R);
+        for (i=nt-1; i>=0; i--)
+            if (!run[i]) ECP_muln(&(J[i].R),J[i].P,J[i].k,J[i].n);
+        for (i=0; i<nt; i++)
+        {
+            if (run[i]) pthread_join(id[i],NULL);
+            ECP_add(R,&(J[i].R));
+        }
+        ECP_affine(R);
+        return;
+    }
+#else
+    (void)nt;
+#endif
+    ECP_muln(R,P,k,n);
+}
+
 #endif
 
 void ZZZ::ECP_cfp(ECP *P)
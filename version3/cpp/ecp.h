@@ -91,6 +91,20 @@ typedef struct
     YYY::FP z;/**< z-coordinate of point */
 } ECP;
 
+#if CURVETYPE_ZZZ!=MONTGOMERY
+/**
+	@brief ECP_precomp structure - fixed base comb tables of a point, for repeated multiplication of the same point
+*/
+
+typedef struct
+{
+    ECP W[PRECOMP_BLOCKS_ZZZ][1<<PRECOMP_WINDOW_ZZZ]; /**< W[j][i] is the sum of 2^((k*PRECOMP_BLOCKS_ZZZ+j)*len).P over the set bits k of i, in affine form */
+#if CURVETYPE_ZZZ==EDWARDS
+    YYY::FP E[PRECOMP_BLOCKS_ZZZ][1<<PRECOMP_WINDOW_ZZZ][3]; /**< entries of W in extended coordinates, as (y+x,y-x,2dxy) if a=-1 and (x,y,dxy) otherwise. Not serialised */
+#endif
+} ECP_precomp;
+#endif
+
 
 /* ECP E(Fp) prototypes */
 /**	@brief Tests for ECP point equal to infinity
@@ -201,6 +215,13 @@ extern void ECP_sub(ECP *P,ECP *Q);
 	@param P ECP instance to be converted to affine form
  */
 extern void ECP_affine(ECP *P);
+/**	@brief Converts an array of ECP points from Projective (x,y,z) coordinates to affine (x,y) coordinates
+ *
+	Shares one field inversion across each batch of up to 8 points, so that the scratch on the stack stays small
+	@param P array of ECP instances to be converted to affine form
+	@param n number of points
+ */
+extern void ECP_affine_batch(ECP *P,int n);
 /**	@brief Formats and outputs an ECP point to the console, in projective coordinates
  *
 	@param P ECP instance to be printed
@@ -260,6 +281,31 @@ extern void ECP_pinmul(ECP *P,int i,int b);
 
  */
 extern void ECP_mul(ECP *P,XXX::BIG b);
+/**	@brief Multiplies an ECP instance P by a BIG, side-channel resistant, leaving the result in projective coordinates
+ *
+	As ECP_mul, but saves the final inversion when the result is only used in further point arithmetic or is serialised.
+	@param P ECP instance, on exit =b*P
+	@param b BIG number multiplier
+ */
+extern void ECP_mul_proj(ECP *P,XXX::BIG b);
+#if CURVETYPE_ZZZ==MONTGOMERY
+/**	@brief x-only Montgomery ladder, as used by X25519 in RFC 7748
+ *
+	Side channel resistant. Faster than ECP_mul, as it works directly on the x-coordinate with a merged ladder step and a single final inversion.
+	Multiplier k is used as given - any clamping is left to the caller. If P has small order r=0
+	@param r BIG on exit = x-coordinate of k*P
+	@param k BIG multiplier, less than 2^MODBITS
+	@param u BIG x-coordinate of P, which is reduced modulo p
+ */
+extern void ECP_ladder(XXX::BIG r,XXX::BIG k,XXX::BIG u);
+#endif
+/**	@brief Multiplies the generator G by a BIG, side-channel resistant
+ *
+	Uses a fixed base comb, with tables of multiples of G built on first use. For Montgomery curves uses ECP_mul.
+	@param P ECP instance, on exit =b*G
+	@param b BIG number multiplier
+ */
+extern void ECP_mul_gen(ECP *P,XXX::BIG b);
 /**	@brief Calculates double multiplication P=e*P+f*Q, side-channel resistant
  *
 	@param P ECP instance, on exit =e*P+f*Q
@@ -268,6 +314,75 @@ extern void ECP_mul(ECP *P,XXX::BIG b);
 	@param f BIG number multiplier
  */
 extern void ECP_mul2(ECP *P,ECP *Q,XXX::BIG e,XXX::BIG f);
+/**	@brief Calculates double multiplication P=e*P+f*Q, side-channel resistant, leaving the result in projective coordinates
+ *
+	@param P ECP instance, on exit =e*P+f*Q
+	@param Q ECP instance
+	@param e BIG number multiplier
+	@param f BIG number multiplier
+ */
+extern void ECP_mul2_proj(ECP *P,ECP *Q,XXX::BIG e,XXX::BIG f);
+/**	@brief Calculates multi-multiplication R=k[0]*P[0]+k[1]*P[1]+...+k[n-1]*P[n-1]
+ *
+	Uses Straus method for small n, and Pippenger buckets for large n. Not constant time, so only for public multipliers and points.
+	At most 130 ECPs are on the stack, either a table of 8 for each of up to 16 terms, or 128 buckets for a window of 8 bits.
+	That is about 25 KB for BLS383 on a 64-bit build.
+	@param R ECP instance, on exit =k[0]*P[0]+...+k[n-1]*P[n-1]
+	@param P ECP array of n points
+	@param k BIG array of n multipliers
+	@param n number of terms
+ */
+extern void ECP_muln(ECP *R,ECP *P,XXX::BIG *k,int n);
+/**	@brief Calculates multi-multiplication R=k[0]*P[0]+k[1]*P[1]+...+k[n-1]*P[n-1] using several threads
+ *
+	As ECP_muln, but the terms are split into nt slices which are summed in parallel. The result does not depend on nt.
+	Threads are only used if THREADS is defined in arch.h, otherwise this is the same as ECP_muln. Not constant time.
+	@param R ECP instance, on exit =k[0]*P[0]+...+k[n-1]*P[n-1]
+	@param P ECP array of n points
+	@param k BIG array of n multipliers
+	@param n number of terms
+	@param nt number of threads, at most 64
+ */
+extern void ECP_muln_mt(ECP *R,ECP *P,XXX::BIG *k,int n,int nt);
+#if CURVETYPE_ZZZ!=MONTGOMERY
+/**	@brief Builds fixed base comb tables for repeated multiplication of a point
+ *
+	@param T ECP_precomp instance, on exit the comb tables of P
+	@param P ECP instance
+ */
+extern void ECP_precomp_init(ECP_precomp *T,ECP *P);
+/**	@brief Formats precomputed comb tables to an octet string
+ *
+	The octet string is the uncompressed encodings of the table entries, except for the entries at infinity W[j][0]. Its length is PRECOMP_BLOCKS_ZZZ*(2^PRECOMP_WINDOW_ZZZ-1)*(2*MODBYTES_XXX+1)
+	@param S output octet string
+	@param T ECP_precomp instance to be converted to an octet string
+ */
+extern void ECP_precomp_toOctet(octet *S,ECP_precomp *T);
+/**	@brief Restores precomputed comb tables from an octet string
+ *
+	Each entry is checked to be on the curve, but not that the entries are multiples of one point
+	@param T ECP_precomp instance to be restored
+	@param S input octet string
+	@return 1 if the octet string is a valid table, else 0
+ */
+extern int ECP_precomp_fromOctet(ECP_precomp *T,octet *S);
+/**	@brief Multiplies a point by a BIG using its precomputed comb tables, side-channel resistant
+ *
+	@param P ECP instance, on exit =e*Q
+	@param T ECP_precomp tables of Q
+	@param e BIG number multiplier
+ */
+extern void ECP_mul_precomp(ECP *P,ECP_precomp *T,XXX::BIG e);
+/**	@brief Calculates double multiplication P=e*Q+f*R using precomputed comb tables, side-channel resistant
+ *
+	@param P ECP instance, on exit =e*Q+f*R
+	@param T ECP_precomp tables of Q
+	@param e BIG number multiplier
+	@param U ECP_precomp tables of R
+	@param f BIG number multiplier
+ */
+extern void ECP_mul2_precomp(ECP *P,ECP_precomp *T,XXX::BIG e,ECP_precomp *U,XXX::BIG f);
+#endif
 
 /**	@brief Multiplies random point by co-factor
  *
@@ -22,6 +22,10 @@ under the License.
 
 #include "ecp2_ZZZ.h"
 
+#ifdef THREADS
+#include <pthread.h>
+#endif
+
 using namespace XXX;
 using namespace YYY;
 
@@ -64,23 +68,18 @@ static int teq(sign32 b,sign32 c)
     return (int)((x>>31)&1);
 }
 
-/* Constant time select from pre-computed table */
-static void ECP2_select(ZZZ::ECP2 *P,ZZZ::ECP2 W[],sign32 b)
+/* Constant time select from pre-computed table of n odd multiples */
+static void ECP2_select(ZZZ::ECP2 *P,ZZZ::ECP2 W[],sign32 b,int n)
 {
+    int i;
     ZZZ::ECP2 MP;
     sign32 m=b>>31;
     sign32 babs=(b^m)-m;
 
     babs=(babs-1)/2;
 
-    ECP2_cmove(P,&W[0],teq(babs,0));  // conditional move
-    ECP2_cmove(P,&W[1],teq(babs,1));
-    ECP2_cmove(P,&W[2],teq(babs,2));
-    ECP2_cmove(P,&W[3],teq(babs,3));
-    ECP2_cmove(P,&W[4],teq(babs,4));
-    ECP2_cmove(P,&W[5],teq(babs,5));
-    ECP2_cmove(P,&W[6],teq(babs,6));
-    ECP2_cmove(P,&W[7],teq(babs,7));
+    for (i=0; i<n; i++)
+        ECP2_cmove(P,&W[i],teq(babs,i));  // conditional move
 
     ECP2_copy(&MP,P);
     ECP2_neg(&MP);  // minus P
@@ -127,6 +126,35 @@ void ZZZ::ECP2_affine(ECP2 *P)
     FP2_copy(&(P->z),&one);
 }
 
+#define AFFINE_BATCH 8 /* maximum number of points sharing one inversion */
+
+/* Convert n points to affine, with one inversion per AFFINE_BATCH points */
+void ZZZ::ECP2_affine_batch(ECP2 *P,int n)
+{
+	int i,j,m;
+	FP2 z[AFFINE_BATCH],iz[AFFINE_BATCH];
+
+	for (j=0;j<n;j+=AFFINE_BATCH)
+	{
+		m=n-j;
+		if (m>AFFINE_BATCH) m=AFFINE_BATCH;
+		for (i=0;i<m;i++)
+			FP2_copy(&z[i],&(P[j+i].z));
+
+		FP2_inv_batch(iz,z,m);
+
+		for (i=0;i<m;i++)
+		{
+			if (ECP2_isinf(&P[j+i])) continue;
+			FP2_mul(&(P[j+i].x),&(P[j+i].x),&iz[i]);
+			FP2_mul(&(P[j+i].y),&(P[j+i].y),&iz[i]);
+			FP2_reduce(&(P[j+i].x));
+			FP2_reduce(&(P[j+i].y));
+			FP2_one(&(P[j+i].z));
+		}
+	}
+}
+
 /* extract x, y from point P */
 /* SU= 16 */
 int ZZZ::ECP2_get(FP2 *x,FP2 *y,ECP2 *P)
@@ -451,6 +479,83 @@ int ZZZ::ECP2_add(ECP2 *P,ECP2 *Q)
     return 0;
 }
 
+/* Set P+=Q, where Q is in affine form (Z=1) and is not the point at infinity */
+/* Mixed addition formulas, saving one multiplication and some additions over ECP2_add */
+static void ECP2_addaff(ZZZ::ECP2 *P,ZZZ::ECP2 *Q)
+{
+    FP2 t0,t1,t2,t3,t4,x3,y3,z3;
+	int b3=3*ZZZ::CURVE_B_I;
+
+	FP2_mul(&t0,&(P->x),&(Q->x));
+	FP2_mul(&t1,&(P->y),&(Q->y));
+
+	FP2_add(&t3,&(P->x),&(P->y));
+	FP2_norm(&t3);
+	FP2_add(&t4,&(Q->x),&(Q->y));
+	FP2_norm(&t4);
+	FP2_mul(&t3,&t3,&t4);
+
+	FP2_add(&t4,&t0,&t1);
+
+	FP2_sub(&t3,&t3,&t4);
+	FP2_norm(&t3);
+#if SEXTIC_TWIST_ZZZ==D_TYPE
+	FP2_mul_ip(&t3);
+	FP2_norm(&t3);
+#endif
+	FP2_mul(&t4,&(Q->y),&(P->z));
+	FP2_add(&t4,&t4,&(P->y));
+	FP2_norm(&t4);
+#if SEXTIC_TWIST_ZZZ==D_TYPE
+	FP2_mul_ip(&t4);
+	FP2_norm(&t4);
+#endif
+	FP2_mul(&y3,&(Q->x),&(P->z));
+	FP2_add(&y3,&y3,&(P->x));
+	FP2_norm(&y3);
+#if SEXTIC_TWIST_ZZZ==D_TYPE
+	FP2_mul_ip(&t0);
+	FP2_norm(&t0);
+	FP2_mul_ip(&t1);
+	FP2_norm(&t1);
+#endif
+
+	FP2_add(&x3,&t0,&t0);
+	FP2_add(&t0,&t0,&x3);
+	FP2_norm(&t0);
+	FP2_imul(&t2,&(P->z),b3);
+#if SEXTIC_TWIST_ZZZ==M_TYPE
+	FP2_mul_ip(&t2);
+	FP2_norm(&t2);
+#endif
+
+	FP2_add(&z3,&t1,&t2);
+	FP2_norm(&z3);
+	FP2_sub(&t1,&t1,&t2);
+	FP2_norm(&t1);
+
+	FP2_imul(&y3,&y3,b3);
+#if SEXTIC_TWIST_ZZZ==M_TYPE
+	FP2_mul_ip(&y3);
+	FP2_norm(&y3);
+#endif
+
+	FP2_mul(&x3,&y3,&t4);
+	FP2_mul(&t2,&t3,&t1);
+	FP2_sub(&(P->x),&t2,&x3);
+	FP2_mul(&y3,&y3,&t0);
+	FP2_mul(&t1,&t1,&z3);
+	FP2_add(&(P->y),&y3,&t1);
+
+	FP2_mul(&t0,&t0,&t3);
+	FP2_mul(&z3,&z3,&t4);
+	FP2_add(&(P->z),&z3,&t0);
+
+	FP2_norm(&(P->x));
+	FP2_norm(&(P->y));
+	FP2_norm(&(P->z));
+}
+
 /* Set P-=Q */
 /* SU= 16 */
 void ZZZ::ECP2_sub(ECP2 *P,ECP2 *Q)
@@ -461,15 +566,15 @@ void ZZZ::ECP2_sub(ECP2 *P,ECP2 *Q)
     ECP2_add(P,&NQ);
 }
 
-/* P*=e */
+/* P*=e, leaving P in projective coordinates */
 /* SU= 280 */
-void ZZZ::ECP2_mul(ECP2 *P,BIG e)
+void ZZZ::ECP2_mul_proj(ECP2 *P,BIG e)
 {
     /* fixed size windows */
-    int i,nb,s,ns;
+    int i,j,nb,s,ns;
     BIG mt,t;
-    ECP2 Q,W[8],C;
-    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+3)/4];
+    ECP2 Q,W[1<<(MUL_WINDOW_ZZZ-1)],C;
+    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ];
 
     if (ECP2_isinf(P)) return;
 
@@ -479,7 +584,7 @@ void ZZZ::ECP2_mul(ECP2 *P,BIG e)
     ECP2_dbl(&Q);
     ECP2_copy(&W[0],P);
 
-    for (i=1; i<8; i++)
+    for (i=1; i<(1<<(MUL_WINDOW_ZZZ-1)); i++)
     {
         ECP2_copy(&W[i],&W[i-1]);
         ECP2_add(&W[i],&Q);
@@ -498,29 +603,210 @@ void ZZZ::ECP2_mul(ECP2 *P,BIG e)
     ECP2_cmove(&Q,P,ns);
     ECP2_copy(&C,&Q);
 
-    nb=1+(BIG_nbits(t)+3)/4;
+    nb=1+(BIG_nbits(t)+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ;
 
-    /* convert exponent to signed 4-bit window */
+    /* convert exponent to signed MUL_WINDOW_ZZZ-bit window */
     for (i=0; i<nb; i++)
     {
-        w[i]=BIG_lastbits(t,5)-16;
+        w[i]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1)-(1<<MUL_WINDOW_ZZZ);
         BIG_dec(t,w[i]);
         BIG_norm(t);
-        BIG_fshr(t,4);
+        BIG_fshr(t,MUL_WINDOW_ZZZ);
     }
-    w[nb]=BIG_lastbits(t,5);
+    w[nb]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1);
 
     ECP2_copy(P,&W[(w[nb]-1)/2]);
     for (i=nb-1; i>=0; i--)
     {
-        ECP2_select(&Q,W,w[i]);
-        ECP2_dbl(P);
+        ECP2_select(&Q,W,w[i],1<<(MUL_WINDOW_ZZZ-1));
+        for (j=0; j<MUL_WINDOW_ZZZ; j++)
+            ECP2_dbl(P);
+        ECP2_add(P,&Q);
+    }
+    ECP2_sub(P,&C); /* apply correction */
+}
+
+/* P*=e */
+void ZZZ::ECP2_mul(ECP2 *P,BIG e)
+{
+    ECP2_mul_proj(P,e);
+    ECP2_affine(P);
+}
+
+/* run length of the comb tables built by ECP2_precomp_init, which cover the full width of a BIG */
+#define PRECOMP_LEN ((NLEN_XXX*BASEBITS_XXX+PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ-1)/(PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ))
+
+/* Build fixed base comb tables for Q, with runs of len bits. The multiplier is split into PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ runs */
+/* W[j][i] is the sum of 2^((k*PRECOMP_BLOCKS_ZZZ+j)*len).Q over the set bits k of i */
+static void ECP2_comb_init(ZZZ::ECP2_precomp *T,ZZZ::ECP2 *Q,int len)
+{
+    int i,j,k;
+    ZZZ::ECP2 B[PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ];
+
+    ZZZ::ECP2_copy(&B[0],Q);
+    for (i=1; i<PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ; i++)
+    {
+        ZZZ::ECP2_copy(&B[i],&B[i-1]);
+        for (k=0; k<len; k++) ZZZ::ECP2_dbl(&B[i]);
+    }
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ZZZ::ECP2_inf(&(T->W[j][0]));
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            for (k=0; ((i>>k)&1)==0; k++) ;
+            ZZZ::ECP2_copy(&(T->W[j][i]),&(T->W[j][i&(i-1)]));
+            ZZZ::ECP2_add(&(T->W[j][i]),&B[k*PRECOMP_BLOCKS_ZZZ+j]);
+        }
+        ZZZ::ECP2_affine_batch(T->W[j],1<<PRECOMP_WINDOW_ZZZ);
+    }
+}
+
+/* Build comb tables for the generator, for multipliers less than the group order. The run length is returned */
+static int ECP2_comb_gen(ZZZ::ECP2_precomp *T)
+{
+    int len;
+    BIG r;
+    ZZZ::ECP2 G;
+    BIG_rcopy(r,ZZZ::CURVE_Order);
+    len=(BIG_nbits(r)+PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ-1)/(PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ);
+    ZZZ::ECP2_generator(&G);
+    ECP2_comb_init(T,&G,len);
+    return len;
+}
+
+/* Constant time select W[b] from comb table */
+static void ECP2_comb_select(ZZZ::ECP2 *P,ZZZ::ECP2 W[],sign32 b)
+{
+    int i;
+    for (i=0; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        ECP2_cmove(P,&W[i],teq(b,i));
+}
+
+/* Add column i of the comb tables, as selected by the bits of t */
+/* Table entries are affine, so mixed addition is used. Any infinite entry, such as W[j][0] or every entry when Q is infinity, is masked out */
+static void ECP2_comb_add(ZZZ::ECP2 *P,ZZZ::ECP2_precomp *T,BIG t,int len,int i)
+{
+    int j,k,m;
+    sign32 b;
+    ZZZ::ECP2 Q,R;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        b=0;
+        for (k=0; k<PRECOMP_WINDOW_ZZZ; k++)
+        {
+            m=(k*PRECOMP_BLOCKS_ZZZ+j)*len+i;
+            if (m<NLEN_XXX*BASEBITS_XXX) b|=BIG_bit(t,m)<<k;
+        }
+        ECP2_comb_select(&Q,T->W[j],b);
+        ZZZ::ECP2_copy(&R,P);
+        ECP2_addaff(&R,&Q);
+        ECP2_cmove(P,&R,1-(teq(b,0)|ZZZ::ECP2_isinf(&Q)));
+    }
+}
+
+/* Set P=e*G, where G is the generator */
+void ZZZ::ECP2_mul_gen(ECP2 *P,BIG e)
+{
+    /* Lim-Lee fixed base comb. The table is built on first use - static initialisation is thread safe */
+    static ECP2_precomp T;
+    static const int len=ECP2_comb_gen(&T);
+    int i;
+    BIG r,t;
+
+    BIG_rcopy(r,CURVE_Order);
+    BIG_copy(t,e);
+    BIG_norm(t);
+    BIG_mod(t,r);
+
+    ECP2_inf(P);
+    for (i=len-1; i>=0; i--)
+    {
         ECP2_dbl(P);
+        ECP2_comb_add(P,&T,t,len,i);
+    }
+    ECP2_affine(P);
+}
+
+/* Build comb tables for P, for multipliers which fill a BIG */
+void ZZZ::ECP2_precomp_init(ECP2_precomp *T,ECP2 *P)
+{
+    ECP2_comb_init(T,P,PRECOMP_LEN);
+}
+
+/* Output table to octet string, as the encodings of its entries. The first entry of each table is the point at infinity, and is omitted */
+void ZZZ::ECP2_precomp_toOctet(octet *S,ECP2_precomp *T)
+{
+    int i,j;
+    octet E;
+    S->len=0;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            E.len=0;
+            E.max=4*MODBYTES_XXX;
+            E.val=&(S->val[S->len]);
+            ECP2_toOctet(&E,&(T->W[j][i]));
+            S->len+=E.len;
+        }
+}
+
+/* Restore table from octet string. Returns 0 if any entry is not on the curve */
+int ZZZ::ECP2_precomp_fromOctet(ECP2_precomp *T,octet *S)
+{
+    int i,j;
+    octet E;
+    if (S->len!=PRECOMP_BLOCKS_ZZZ*((1<<PRECOMP_WINDOW_ZZZ)-1)*4*MODBYTES_XXX) return 0;
+    E.len=E.max=4*MODBYTES_XXX;
+    E.val=S->val;
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ECP2_inf(&(T->W[j][0]));
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            if (!ECP2_fromOctet(&(T->W[j][i]),&E)) return 0;
+            E.val+=E.len;
+        }
+    }
+    return 1;
+}
+
+/* Set P=e.Q, where T was built from Q by ECP2_precomp_init */
+void ZZZ::ECP2_mul_precomp(ECP2 *P,ECP2_precomp *T,BIG e)
+{
+    int i;
+    BIG t;
+
+    BIG_copy(t,e);
+    BIG_norm(t);
+
+    ECP2_inf(P);
+    for (i=PRECOMP_LEN-1; i>=0; i--)
+    {
         ECP2_dbl(P);
+        ECP2_comb_add(P,T,t,PRECOMP_LEN,i);
+    }
+    ECP2_affine(P);
+}
+
+/* Set P=e.Q+f.R, where T and U were built from Q and R by ECP2_precomp_init */
+void ZZZ::ECP2_mul2_precomp(ECP2 *P,ECP2_precomp *T,BIG e,ECP2_precomp *U,BIG f)
+{
+    int i;
+    BIG te,tf;
+
+    BIG_copy(te,e);
+    BIG_norm(te);
+    BIG_copy(tf,f);
+    BIG_norm(tf);
+
+    ECP2_inf(P);
+    for (i=PRECOMP_LEN-1; i>=0; i--)
+    {
         ECP2_dbl(P);
-        ECP2_add(P,&Q);
+        ECP2_comb_add(P,T,te,PRECOMP_LEN,i);
+        ECP2_comb_add(P,U,tf,PRECOMP_LEN,i);
     }
-    ECP2_sub(P,&C); /* apply correction */
     ECP2_affine(P);
 }
 
@@ -543,7 +829,7 @@ void ZZZ::ECP2_frob(ECP2 *P,FP2 *X)
 // Faz-Hernandez & Longa & Sanchez  https://eprint.iacr.org/2013/158.pdf
 // Side channel attack secure 
 
-void ZZZ::ECP2_mul4(ECP2 *P,ECP2 Q[4],BIG u[4])
+void ZZZ::ECP2_mul4_proj(ECP2 *P,ECP2 Q[4],BIG u[4])
 {
     int i,j,k,nb,pb,bt;
 	ECP2 T[8],W;
@@ -612,10 +898,10 @@ void ZZZ::ECP2_mul4(ECP2 *P,ECP2 Q[4],BIG u[4])
     }		
 
 // Main loop
-	ECP2_select(P,T,2*w[nb-1]+1);
+	ECP2_select(P,T,2*w[nb-1]+1,8);
     for (i=nb-2; i>=0; i--)
     {
-        ECP2_select(&W,T,2*w[i]+s[i]);
+        ECP2_select(&W,T,2*w[i]+s[i],8);
         ECP2_dbl(P);
         ECP2_add(P,&W);
     }
@@ -624,10 +910,286 @@ void ZZZ::ECP2_mul4(ECP2 *P,ECP2 Q[4],BIG u[4])
 	ECP2_copy(&W,P);   
 	ECP2_sub(&W,&Q[0]);
 	ECP2_cmove(P,&W,pb);
+}
 
+/* P=u0.Q0+u1*Q1+u2*Q2+u3*Q3 */
+void ZZZ::ECP2_mul4(ECP2 *P,ECP2 Q[4],BIG u[4])
+{
+    ECP2_mul4_proj(P,Q,u);
     ECP2_affine(P);
 }
 
+#define MULN_STRAUS 16 /* Straus for up to this many points, Pippenger buckets for more */
+#define MULN_MAXWIN 8 /* largest Pippenger window, which bounds the number of buckets */
+
+/* test for affine form Z=1 */
+static int ECP2_isaff(ZZZ::ECP2 *P)
+{
+    return FP2_isunity(&(P->z));
+}
+
+/* Set P+=Q or P-=Q as s is 0 or 1, with mixed addition if Q is affine - not constant time */
+static void ECP2_addsign(ZZZ::ECP2 *P,ZZZ::ECP2 *Q,int s)
+{
+    ZZZ::ECP2 NQ;
+    ZZZ::ECP2_copy(&NQ,Q);
+    if (s) ZZZ::ECP2_neg(&NQ);
+    if (ECP2_isaff(&NQ)) ECP2_addaff(P,&NQ);
+    else ZZZ::ECP2_add(P,&NQ);
+}
+
+/* Number of signed c bit digits for multipliers of mb bits. The top digit keeps a spare bit so that k+H below does not overflow */
+static int ECP2_muln_digits(int mb,int c)
+{
+    return (mb+c+1)/c;
+}
+
+/* Set kh=k+H, where H has bit c-1 of each of nw windows set. Digit i of k is then window i of kh less 2^(c-1) */
+static void ECP2_muln_offset(BIG kh,BIG k,BIG h)
+{
+    BIG_copy(kh,k);
+    BIG_norm(kh);
+    BIG_add(kh,kh,h);
+    BIG_norm(kh);
+}
+
+/* H for nw windows of c bits */
+static void ECP2_muln_h(BIG h,int c,int nw)
+{
+    int i;
+    BIG_zero(h);
+    for (i=0; i<nw; i++)
+    {
+        BIG_shl(h,c);
+        BIG_inc(h,1<<(c-1));
+    }
+}
+
+/* Signed digit i, in the range -2^(c-1) to 2^(c-1)-1 */
+static int ECP2_muln_digit(BIG kh,int i,int c)
+{
+    int j,d=0;
+    for (j=c-1; j>=0; j--)
+        d=2*d+BIG_bit(kh,c*i+j);
+    return d-(1<<(c-1));
+}
+
+/* R+=k[0].P[0]+...+k[n-1].P[n-1] by Straus with signed 4 bit windows, for n<=MULN_STRAUS and multipliers of mb bits */
+NOINLINE
+static void ECP2_muln_straus(ZZZ::ECP2 *R,ZZZ::ECP2 *P,BIG *k,int n,int mb)
+{
+    int i,j,c,nw,d,s;
+    ZZZ::ECP2 T[MULN_STRAUS][8];
+    BIG K[MULN_STRAUS],h;
+
+    c=4;
+    nw=ECP2_muln_digits(mb,c);
+    ECP2_muln_h(h,c,nw);
+    for (j=0; j<n; j++)
+    {
+        ECP2_muln_offset(K[j],k[j],h);
+        ZZZ::ECP2_copy(&T[j][0],&P[j]);
+        ZZZ::ECP2_copy(&T[j][1],&P[j]);
+        ZZZ::ECP2_dbl(&T[j][1]);
+        for (i=2; i<8; i++)
+        {
+            ZZZ::ECP2_copy(&T[j][i],&T[j][i-1]);
+            ZZZ::ECP2_add(&T[j][i],&P[j]);
+        }
+    }
+    ZZZ::ECP2_affine_batch(&T[0][0],8*n);
+    for (i=nw-1; i>=0; i--)
+    {
+        for (j=0; j<c; j++) ZZZ::ECP2_dbl(R);
+        for (j=0; j<n; j++)
+        {
+            d=ECP2_muln_digit(K[j],i,c);
+            if (d==0) continue;
+            s=(d<0);
+            if (s) d=-d;
+            ECP2_addsign(R,&T[j][d-1],s);
+        }
+    }
+}
+
+/* R+=k[0].P[0]+...+k[n-1].P[n-1] by Pippenger buckets, with the window size chosen for n and multipliers of mb bits */
+NOINLINE
+static void ECP2_muln_pippenger(ZZZ::ECP2 *R,ZZZ::ECP2 *P,BIG *k,int n,int mb)
+{
+    int i,j,c,nw,nb,d,s,cost,best,fs,fq;
+    ZZZ::ECP2 B[1<<(MULN_MAXWIN-1)],S,Q;
+    char full[1<<(MULN_MAXWIN-1)];
+    BIG kh,h;
+
+    /* choose the window minimising the number of additions */
+    c=0;
+    best=0;
+    for (i=2; i<=MULN_MAXWIN; i++)
+    {
+        nw=ECP2_muln_digits(mb,i);
+        cost=nw*(n+(1<<i)+i);
+        if (c==0 || cost<best)
+        {
+            c=i;
+            best=cost;
+        }
+    }
+    nw=ECP2_muln_digits(mb,c);
+    nb=1<<(c-1);
+    ECP2_muln_h(h,c,nw);
+
+    for (i=nw-1; i>=0; i--)
+    {
+        for (j=0; j<c; j++) ZZZ::ECP2_dbl(R);
+
+        /* fill buckets */
+        for (j=0; j<nb; j++) full[j]=0;
+        for (j=0; j<n; j++)
+        {
+            ECP2_muln_offset(kh,k[j],h);
+            d=ECP2_muln_digit(kh,i,c);
+            if (d==0) continue;
+            s=(d<0);
+            if (s) d=-d;
+            if (full[d-1])
+                ECP2_addsign(&B[d-1],&P[j],s);
+            else
+            {
+                ZZZ::ECP2_copy(&B[d-1],&P[j]);
+                if (s) ZZZ::ECP2_neg(&B[d-1]);
+                full[d-1]=1;
+            }
+        }
+
+        /* sum of (j+1).B[j] as a sum of running sums */
+        fs=fq=0;
+        for (j=nb-1; j>=0; j--)
+        {
+            if (full[j])
+            {
+                if (fq) ZZZ::ECP2_add(&Q,&B[j]);
+                else ZZZ::ECP2_copy(&Q,&B[j]);
+                fq=1;
+            }
+            if (fq)
+            {
+                if (fs) ZZZ::ECP2_add(&S,&Q);
+                else ZZZ::ECP2_copy(&S,&Q);
+                fs=1;
+            }
+        }
+        if (fs) ZZZ::ECP2_add(R,&S);
+    }
+}
+
+/* Set R=k[0].P[0]+k[1].P[1]+...+k[n-1].P[n-1] */
+/* Straus for small n, else Pippenger buckets. Each has its own function, so that only its own tables are on the stack */
+void ZZZ::ECP2_muln(ECP2 *R,ECP2 *P,BIG *k,int n)
+{
+    int j,mb;
+    BIG kh;
+
+    ECP2_inf(R);
+    if (n<=0) return;
+    mb=0;
+    for (j=0; j<n; j++)
+    {
+        BIG_copy(kh,k[j]);
+        BIG_norm(kh);
+        if (BIG_nbits(kh)>mb) mb=BIG_nbits(kh);
+    }
+    if (mb==0) return;
+
+    if (mb+MULN_MAXWIN+1>NLEN_XXX*BASEBITS_XXX)
+    {
+        /* no room in a BIG for the digit offsets - multiply one at a time */
+        ECP2 Q;
+        for (j=0; j<n; j++)
+        {
+            ECP2_copy(&Q,&P[j]);
+            ECP2_mul_proj(&Q,k[j]);
+            ECP2_add(R,&Q);
+        }
+        ECP2_affine(R);
+        return;
+    }
+
+    if (n<=MULN_STRAUS) ECP2_muln_straus(R,P,k,n,mb);
+    else ECP2_muln_pippenger(R,P,k,n,mb);
+    ECP2_affine(R);
+}
+
+#define MULN_THREADS 64 /* most threads used by ECP2_muln_mt */
+
+#ifdef THREADS
+
+/* one slice of the terms of ECP2_muln_mt */
+typedef struct
+{
+    ZZZ::ECP2 R;
+    ZZZ::ECP2 *P;
+    BIG *k;
+    int n;
+} ECP2_muln_job_ZZZ;
+
+static void *ECP2_muln_worker(void *arg)
+{
+    ECP2_muln_job_ZZZ *J=(ECP2_muln_job_ZZZ *)arg;
+    ZZZ::ECP2_muln(&(J->R),J->P,J->k,J->n);
+    return NULL;
+}
+
+#endif
+
+/* Set R=k[0].P[0]+k[1].P[1]+...+k[n-1].P[n-1] */
+/* The terms are split into nt slices of consecutive terms, each summed by ECP2_muln in its own thread. The slice sums are added in order */
+void ZZZ::ECP2_muln_mt(ECP2 *R,ECP2 *P,BIG *k,int n,int nt)
+{
+#ifdef THREADS
+    int i,m,done;
+    pthread_t id[MULN_THREADS];
+    char run[MULN_THREADS];
+    ECP2_muln_job_ZZZ J[MULN_THREADS];
+    pthread_attr_t attr;
+
+    if (nt>MULN_THREADS) nt=MULN_THREADS;
+    if (nt>n/(MULN_STRAUS+1)) nt=n/(MULN_STRAUS+1); /* keep slices big enough for buckets */
+    if (nt>1)
+    {
+        /* room for the buckets, which are on the stack */
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr,sizeof(ECP2)*((1<<(MULN_MAXWIN-1))+8*MULN_STRAUS)+(1<<18));
+        done=0;
+        for (i=0; i<nt; i++)
+        {
+            m=(n-done)/(nt-i);
+            J[i].P=&P[done];
+            J[i].k=&k[done];
+            J[i].n=m;
+            done+=m;
+            run[i]=0;
+            if (i<nt-1) run[i]=(pthread_create(&id[i],&attr,ECP2_muln_worker,&J[i])==0);
+        }
+        pthread_attr_destroy(&attr);
+
+        /* last slice, and any that did not get a thread, in this thread */
+        ECP2_inf(R);
+        for (i=nt-1; i>=0; i--)
+            if (!run[i]) ECP2_muln(&(J[i].R),J[i].P,J[i].k,J[i].n);
+        for (i=0; i<nt; i++)
+        {
+            if (run[i]) pthread_join(id[i],NULL);
+            ECP2_add(R,&(J[i].R));
+        }
+        ECP2_affine(R);
+        return;
+    }
+#else
+    (void)nt;
+#endif
+    ECP2_muln(R,P,k,n);
+}
+
 
 /* Map to hash value to point on G2 from random BIG */
 
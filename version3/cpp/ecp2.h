@@ -28,6 +28,15 @@ typedef struct
     YYY::FP2 z;   /**< z-coordinate of point */
 } ECP2;
 
+/**
+	@brief ECP2_precomp structure - fixed base comb tables of a point, for repeated multiplication of the same point
+*/
+
+typedef struct
+{
+    ECP2 W[PRECOMP_BLOCKS_ZZZ][1<<PRECOMP_WINDOW_ZZZ]; /**< W[j][i] is the sum of 2^((k*PRECOMP_BLOCKS_ZZZ+j)*len).P over the set bits k of i, in affine form */
+} ECP2_precomp;
+
 
 /* Curve Params - see rom.c */
 extern const int CURVE_A;		/**< Elliptic curve A parameter */
@@ -80,6 +89,13 @@ extern int ECP2_equals(ECP2 *P,ECP2 *Q);
 	@param P ECP2 instance to be converted to affine form
  */
 extern void ECP2_affine(ECP2 *P);
+/**	@brief Converts an array of ECP2 points from Projective (x,y,z) coordinates to affine (x,y) coordinates
+ *
+	Shares one field inversion across each batch of up to 8 points, so that the scratch on the stack stays small
+	@param P array of ECP2 instances to be converted to affine form
+	@param n number of points
+ */
+extern void ECP2_affine_batch(ECP2 *P,int n);
 /**	@brief Extract x and y coordinates of an ECP2 point P
  *
 	If x=y, returns only x
@@ -171,6 +187,57 @@ extern void ECP2_sub(ECP2 *P,ECP2 *Q);
 
  */
 extern void ECP2_mul(ECP2 *P,XXX::BIG b);
+/**	@brief Multiplies an ECP2 instance P by a BIG, side-channel resistant, leaving the result in projective coordinates
+ *
+	As ECP2_mul, but saves the final inversion when the result is only used in further point arithmetic or is serialised.
+	@param P ECP2 instance, on exit =b*P
+	@param b BIG number multiplier
+ */
+extern void ECP2_mul_proj(ECP2 *P,XXX::BIG b);
+/**	@brief Multiplies the generator G by a BIG, side-channel resistant
+ *
+	Uses a fixed base comb, with tables of multiples of G built on first use.
+	@param P ECP2 instance, on exit =b*G
+	@param b BIG number multiplier
+ */
+extern void ECP2_mul_gen(ECP2 *P,XXX::BIG b);
+/**	@brief Builds fixed base comb tables for repeated multiplication of a point
+ *
+	@param T ECP2_precomp instance, on exit the comb tables of P
+	@param P ECP2 instance
+ */
+extern void ECP2_precomp_init(ECP2_precomp *T,ECP2 *P);
+/**	@brief Formats precomputed comb tables to an octet string
+ *
+	The octet string is the encodings of the table entries, except for the entries at infinity W[j][0]. Its length is PRECOMP_BLOCKS_ZZZ*(2^PRECOMP_WINDOW_ZZZ-1)*4*MODBYTES_XXX
+	@param S output octet string
+	@param T ECP2_precomp instance to be converted to an octet string
+ */
+extern void ECP2_precomp_toOctet(octet *S,ECP2_precomp *T);
+/**	@brief Restores precomputed comb tables from an octet string
+ *
+	Each entry is checked to be on the curve, but not that the entries are multiples of one point
+	@param T ECP2_precomp instance to be restored
+	@param S input octet string
+	@return 1 if the octet string is a valid table, else 0
+ */
+extern int ECP2_precomp_fromOctet(ECP2_precomp *T,octet *S);
+/**	@brief Multiplies a point by a BIG using its precomputed comb tables, side-channel resistant
+ *
+	@param P ECP2 instance, on exit =e*Q
+	@param T ECP2_precomp tables of Q
+	@param e BIG number multiplier
+ */
+extern void ECP2_mul_precomp(ECP2 *P,ECP2_precomp *T,XXX::BIG e);
+/**	@brief Calculates double multiplication P=e*Q+f*R using precomputed comb tables, side-channel resistant
+ *
+	@param P ECP2 instance, on exit =e*Q+f*R
+	@param T ECP2_precomp tables of Q
+	@param e BIG number multiplier
+	@param U ECP2_precomp tables of R
+	@param f BIG number multiplier
+ */
+extern void ECP2_mul2_precomp(ECP2 *P,ECP2_precomp *T,XXX::BIG e,ECP2_precomp *U,XXX::BIG f);
 /**	@brief Multiplies an ECP2 instance P by the internal modulus p, using precalculated Frobenius constant f
  *
 	Fast point multiplication using Frobenius
@@ -186,6 +253,35 @@ extern void ECP2_frob(ECP2 *P,YYY::FP2 *f);
 	@param b BIG array of 4 multipliers
  */
 extern void ECP2_mul4(ECP2 *P,ECP2 *Q,XXX::BIG *b);
+/**	@brief Calculates P=b[0]*Q[0]+b[1]*Q[1]+b[2]*Q[2]+b[3]*Q[3], leaving the result in projective coordinates
+ *
+	@param P ECP2 instance, on exit = b[0]*Q[0]+b[1]*Q[1]+b[2]*Q[2]+b[3]*Q[3]
+	@param Q ECP2 array of 4 points
+	@param b BIG array of 4 multipliers
+ */
+extern void ECP2_mul4_proj(ECP2 *P,ECP2 *Q,XXX::BIG *b);
+/**	@brief Calculates multi-multiplication R=k[0]*P[0]+k[1]*P[1]+...+k[n-1]*P[n-1]
+ *
+	Uses Straus method for small n, and Pippenger buckets for large n. Not constant time, so only for public multipliers and points.
+	At most 130 ECP2s are on the stack, either a table of 8 for each of up to 16 terms, or 128 buckets for a window of 8 bits.
+	That is about 50 KB for BLS383 on a 64-bit build.
+	@param R ECP2 instance, on exit =k[0]*P[0]+...+k[n-1]*P[n-1]
+	@param P ECP2 array of n points
+	@param k BIG array of n multipliers
+	@param n number of terms
+ */
+extern void ECP2_muln(ECP2 *R,ECP2 *P,XXX::BIG *k,int n);
+/**	@brief Calculates multi-multiplication R=k[0]*P[0]+k[1]*P[1]+...+k[n-1]*P[n-1] using several threads
+ *
+	As ECP2_muln, but the terms are split into nt slices which are summed in parallel. The result does not depend on nt.
+	Threads are only used if THREADS is defined in arch.h, otherwise this is the same as ECP2_muln. Not constant time.
+	@param R ECP2 instance, on exit =k[0]*P[0]+...+k[n-1]*P[n-1]
+	@param P ECP2 array of n points
+	@param k BIG array of n multipliers
+	@param n number of terms
+	@param nt number of threads, at most 64
+ */
+extern void ECP2_muln_mt(ECP2 *R,ECP2 *P,XXX::BIG *k,int n,int nt);
 
 /**	@brief Maps random BIG to curve point of correct order
  *
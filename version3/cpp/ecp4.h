@@ -196,6 +196,13 @@ extern void ECP4_sub(ECP4 *P,ECP4 *Q);
 
  */
 extern void ECP4_mul(ECP4 *P,XXX::BIG b);
+/**	@brief Multiplies the generator G by a BIG, side-channel resistant
+ *
+	Uses a fixed base comb, with tables of multiples of G built on first use.
+	@param P ECP4 instance, on exit =b*G
+	@param b BIG number multiplier
+ */
+extern void ECP4_mul_gen(ECP4 *P,XXX::BIG b);
 
 /**	@brief Calculates required Frobenius constants
  *
@@ -63,23 +63,18 @@ static int teq(sign32 b,sign32 c)
     return (int)((x>>31)&1);
 }
 
-/* Constant time select from pre-computed table */
-static void ECP8_select(ZZZ::ECP8 *P,ZZZ::ECP8 W[],sign32 b)
+/* Constant time select from pre-computed table of n odd multiples */
+static void ECP8_select(ZZZ::ECP8 *P,ZZZ::ECP8 W[],sign32 b,int n)
 {
+    int i;
     ZZZ::ECP8 MP;
     sign32 m=b>>31;
     sign32 babs=(b^m)-m;
 
     babs=(babs-1)/2;
 
-    ECP8_cmove(P,&W[0],teq(babs,0));  // conditional move
-    ECP8_cmove(P,&W[1],teq(babs,1));
-    ECP8_cmove(P,&W[2],teq(babs,2));
-    ECP8_cmove(P,&W[3],teq(babs,3));
-    ECP8_cmove(P,&W[4],teq(babs,4));
-    ECP8_cmove(P,&W[5],teq(babs,5));
-    ECP8_cmove(P,&W[6],teq(babs,6));
-    ECP8_cmove(P,&W[7],teq(babs,7));
+    for (i=0; i<n; i++)
+        ECP8_cmove(P,&W[i],teq(babs,i));  // conditional move
 
     ECP8_copy(&MP,P);
     ECP8_neg(&MP);  // minus P
@@ -544,10 +539,10 @@ void ZZZ::ECP8_reduce(ECP8 *P)
 void ZZZ::ECP8_mul(ECP8 *P,BIG e)
 {
     /* fixed size windows */
-    int i,nb,s,ns;
+    int i,j,nb,s,ns;
     BIG mt,t;
-    ECP8 Q,W[8],C;
-    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+3)/4];
+    ECP8 Q,W[1<<(MUL_WINDOW_ZZZ-1)],C;
+    sign8 w[1+(NLEN_XXX*BASEBITS_XXX+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ];
 
     if (ECP8_isinf(P)) return;
 
@@ -557,7 +552,7 @@ void ZZZ::ECP8_mul(ECP8 *P,BIG e)
     ECP8_dbl(&Q);
     ECP8_copy(&W[0],P);
 
-    for (i=1; i<8; i++)
+    for (i=1; i<(1<<(MUL_WINDOW_ZZZ-1)); i++)
     {
         ECP8_copy(&W[i],&W[i-1]);
         ECP8_add(&W[i],&Q);
@@ -576,26 +571,24 @@ void ZZZ::ECP8_mul(ECP8 *P,BIG e)
     ECP8_cmove(&Q,P,ns);
     ECP8_copy(&C,&Q);
 
-    nb=1+(BIG_nbits(t)+3)/4;
+    nb=1+(BIG_nbits(t)+MUL_WINDOW_ZZZ-1)/MUL_WINDOW_ZZZ;
 
-    /* convert exponent to signed 4-bit window */
+    /* convert exponent to signed MUL_WINDOW_ZZZ-bit window */
     for (i=0; i<nb; i++)
     {
-        w[i]=BIG_lastbits(t,5)-16;
+        w[i]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1)-(1<<MUL_WINDOW_ZZZ);
         BIG_dec(t,w[i]);
         BIG_norm(t);
-        BIG_fshr(t,4);
+        BIG_fshr(t,MUL_WINDOW_ZZZ);
     }
-    w[nb]=BIG_lastbits(t,5);
+    w[nb]=BIG_lastbits(t,MUL_WINDOW_ZZZ+1);
 
     ECP8_copy(P,&W[(w[nb]-1)/2]);
     for (i=nb-1; i>=0; i--)
     {
-        ECP8_select(&Q,W,w[i]);
-        ECP8_dbl(P);
-        ECP8_dbl(P);
-        ECP8_dbl(P);
-        ECP8_dbl(P);
+        ECP8_select(&Q,W,w[i],1<<(MUL_WINDOW_ZZZ-1));
+        for (j=0; j<MUL_WINDOW_ZZZ; j++)
+            ECP8_dbl(P);
         ECP8_add(P,&Q);
     }
     ECP8_sub(P,&C); /* apply correction */
@@ -638,6 +631,81 @@ void ZZZ::ECP8_frob_constants(FP2 F[3])
 
 }
 
+/* Build fixed base comb tables for the generator G. The multiplier is split into PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ runs of e bits, and e is returned */
+/* T[j][i] is the sum of 2^((k*PRECOMP_BLOCKS_ZZZ+j)*e).G over the set bits k of i */
+static int ECP8_comb_init(ZZZ::ECP8 T[][1<<PRECOMP_WINDOW_ZZZ])
+{
+    int i,j,k,e;
+    BIG r;
+    ZZZ::ECP8 B[PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ];
+    BIG_rcopy(r,ZZZ::CURVE_Order);
+    e=(BIG_nbits(r)+PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ-1)/(PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ);
+
+    ZZZ::ECP8_generator(&B[0]);
+    for (i=1; i<PRECOMP_WINDOW_ZZZ*PRECOMP_BLOCKS_ZZZ; i++)
+    {
+        ZZZ::ECP8_copy(&B[i],&B[i-1]);
+        for (k=0; k<e; k++) ZZZ::ECP8_dbl(&B[i]);
+    }
+    for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+    {
+        ZZZ::ECP8_inf(&T[j][0]);
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        {
+            for (k=0; ((i>>k)&1)==0; k++) ;
+            ZZZ::ECP8_copy(&T[j][i],&T[j][i&(i-1)]);
+            ZZZ::ECP8_add(&T[j][i],&B[k*PRECOMP_BLOCKS_ZZZ+j]);
+        }
+        for (i=1; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+            ZZZ::ECP8_affine(&T[j][i]);
+    }
+    return e;
+}
+
+/* Constant time select T[b] from comb table */
+static void ECP8_comb_select(ZZZ::ECP8 *P,ZZZ::ECP8 T[],sign32 b)
+{
+    int i;
+    for (i=0; i<(1<<PRECOMP_WINDOW_ZZZ); i++)
+        ECP8_cmove(P,&T[i],teq(b,i));
+}
+
+/* Set P=e*G, where G is the generator */
+void ZZZ::ECP8_mul_gen(ECP8 *P,BIG e)
+{
+    /* Lim-Lee fixed base comb. The table is built on first use - static initialisation is thread safe */
+    static ECP8 T[PRECOMP_BLOCKS_ZZZ][1<<PRECOMP_WINDOW_ZZZ];
+    static const int len=ECP8_comb_init(T);
+    int i,j,k,m,nb;
+    sign32 b;
+    BIG r,t;
+    ECP8 Q;
+
+    BIG_rcopy(r,CURVE_Order);
+    BIG_copy(t,e);
+    BIG_norm(t);
+    BIG_mod(t,r);
+    nb=NLEN_XXX*BASEBITS_XXX;
+
+    ECP8_inf(P);
+    for (i=len-1; i>=0; i--)
+    {
+        ECP8_dbl(P);
+        for (j=0; j<PRECOMP_BLOCKS_ZZZ; j++)
+        {
+            b=0;
+            for (k=0; k<PRECOMP_WINDOW_ZZZ; k++)
+            {
+                m=(k*PRECOMP_BLOCKS_ZZZ+j)*len+i;
+                if (m<nb) b|=BIG_bit(t,m)<<k;
+            }
+            ECP8_comb_select(&Q,T[j],b);
+            ECP8_add(P,&Q);
+        }
+    }
+    ECP8_affine(P);
+}
+
 /* Calculates q^n.P using Frobenius constant X */
 void ZZZ::ECP8_frob(ECP8 *P,FP2 F[3],int n)
 {
@@ -833,24 +901,24 @@ void ZZZ::ECP8_mul16(ECP8 *P,ECP8 Q[16],BIG u[16])
     }	
 
 // Main loop
-	ECP8_select(P,T1,2*w1[nb-1]+1);
-	ECP8_select(&W,T2,2*w2[nb-1]+1);
+	ECP8_select(P,T1,2*w1[nb-1]+1,8);
+	ECP8_select(&W,T2,2*w2[nb-1]+1,8);
 	ECP8_add(P,&W);
-	ECP8_select(&W,T3,2*w3[nb-1]+1);
+	ECP8_select(&W,T3,2*w3[nb-1]+1,8);
 	ECP8_add(P,&W);
-	ECP8_select(&W,T4,2*w4[nb-1]+1);
+	ECP8_select(&W,T4,2*w4[nb-1]+1,8);
 	ECP8_add(P,&W);
 
     for (i=nb-2; i>=0; i--)
     {
         ECP8_dbl(P);
-        ECP8_select(&W,T1,2*w1[i]+s1[i]);
+        ECP8_select(&W,T1,2*w1[i]+s1[i],8);
         ECP8_add(P,&W);
-        ECP8_select(&W,T2,2*w2[i]+s2[i]);
+        ECP8_select(&W,T2,2*w2[i]+s2[i],8);
         ECP8_add(P,&W);
-        ECP8_select(&W,T3,2*w3[i]+s3[i]);
+        ECP8_select(&W,T3,2*w3[i]+s3[i],8);
         ECP8_add(P,&W);
-        ECP8_select(&W,T4,2*w4[i]+s4[i]);
+        ECP8_select(&W,T4,2*w4[i]+s4[i],8);
         ECP8_add(P,&W);
     }
 
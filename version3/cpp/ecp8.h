@@ -206,6 +206,13 @@ extern void ECP8_sub(ECP8 *P,ECP8 *Q);
 
  */
 extern void ECP8_mul(ECP8 *P,XXX::BIG b);
+/**	@brief Multiplies the generator G by a BIG, side-channel resistant
+ *
+	Uses a fixed base comb, with tables of multiples of G built on first use.
+	@param P ECP8 instance, on exit =b*G
+	@param b BIG number multiplier
+ */
+extern void ECP8_mul_gen(ECP8 *P,XXX::BIG b);
 
 /**	@brief Calculates required Frobenius constants
  *
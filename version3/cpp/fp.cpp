@@ -296,10 +296,10 @@ int tadd=0,radd=0,tneg=0,rneg=0;
 int tdadd=0,rdadd=0,tdneg=0,rdneg=0;
 #endif
 
-#ifdef FUSED_MODMUL
-
-/* Insert fastest code here */
+#ifdef FUSED_MODMUL_YYY
 
+/* Interleaved Comba multiplication and Montgomery reduction generated by config script */
+@FMUL@
 #endif
 
 /* r=a*b mod Modulus */
@@ -307,8 +307,6 @@ int tdadd=0,rdadd=0,tdneg=0,rdneg=0;
 /* SU= 88 */
 void YYY::FP_mul(FP *r,FP *a,FP *b)
 {
-    DBIG d;
-    chunk ea,eb;
 
 	if ((sign64)a->XES*b->XES>(sign64)FEXCESS_YYY)
 	{
@@ -318,15 +316,176 @@ void YYY::FP_mul(FP *r,FP *a,FP *b)
         FP_reduce(a);  /* it is sufficient to fully reduce just one of them < p */
 	}
 
-#ifdef FUSED_MODMUL
+#ifdef FUSED_MODMUL_YYY
 	FP_modmul(r->g,a->g,b->g);
 #else
+    DBIG d;
     BIG_mul(d,a->g,b->g);
     FP_mod(r->g,d);
 #endif
 	r->XES=2;
 }
 
+/* r=d mod Modulus, where d is a signed sum of k products, each |product| < p.R */
+/* so add k.p.R to make d positive and less than 2k.p.R */
+void YYY::FP_dmod(FP *r,DBIG d,int k)
+{
+	BIG m;
+	DBIG t;
+	BIG_rcopy(m,Modulus);
+	BIG_pmul(m,m,k);
+	BIG_dsucopy(t,m);
+	BIG_dadd(d,d,t);
+	BIG_dnorm(d);
+	FP_mod(r->g,d);
+	r->XES=2*k+1;
+}
+
+
+#ifdef IFMA_YYY
+
+/* AVX-512 IFMA backend - eight independent Montgomery multiplications, one in each 64-bit lane, using 52-bit digits */
+/* Requires AVX512F and AVX512IFMA instruction set extensions (Intel Ice Lake or later) */
+
+#include <immintrin.h>
+
+#define VLEN_YYY ((NLEN_XXX*BASEBITS_XXX+51)/52)            /**< Number of 52-bit digits needed to hold a normalised BIG */
+#define VSHIFT_YYY (52*VLEN_YYY-NLEN_XXX*BASEBITS_XXX)      /**< Montgomery shift from 2^(BASEBITS*NLEN) to 2^(52*VLEN) */
+#define VMASK_YYY ((((unsign64)1)<<52)-1)
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+namespace YYY {
+	static void ifma_pack(unsign64 *,int,chunk *,int);
+	static void ifma_unpack(chunk *,unsign64 *,int,int);
+	IFMA_TARGET static void ifma_mul_x8(FP *,FP *,FP *);
+}
+
+/* pack normalised non-negative BIG a, shifted left by sh<52 bits, into 52-bit digits w[0],w[st],w[2.st].. */
+/* BASEBITS is at least 52, so each digit is made from at most two BIG digits */
+static void YYY::ifma_pack(unsign64 *w,int st,chunk *a,int sh)
+{
+    int i,k,p,s;
+    unsign64 v;
+    for (k=0; k<VLEN_YYY; k++)
+    {
+        p=52*k-sh;
+        if (p<0) v=(unsign64)a[0]<<(-p);
+        else
+        {
+            i=p/BASEBITS_XXX;
+            s=p%BASEBITS_XXX;
+            v=0;
+            if (i<NLEN_XXX) v=(unsign64)a[i]>>s;
+            if (i+1<NLEN_XXX) v|=(unsign64)a[i+1]<<(BASEBITS_XXX-s);
+        }
+        w[st*k]=v&VMASK_YYY;
+    }
+}
+
+/* unpack nw 52-bit digits w[0],w[st],.. into BIG a. Top digit of a takes all remaining bits */
+static void YYY::ifma_unpack(chunk *a,unsign64 *w,int st,int nw)
+{
+    int i,k,s;
+    unsign64 v;
+    for (i=0; i<NLEN_XXX; i++)
+    {
+        k=(i*BASEBITS_XXX)/52;
+        s=(i*BASEBITS_XXX)%52;
+        v=w[st*k]>>s;
+        if (k+1<nw) v|=w[st*(k+1)]<<(52-s);
+        if (k+2<nw && 104-s<64) v|=w[st*(k+2)]<<(104-s);
+        if (i<NLEN_XXX-1) v&=BMASK_XXX;
+        a[i]=(chunk)v;
+    }
+}
+
+/* r[i]=a[i]*b[i]/2^(BASEBITS*NLEN) mod Modulus. Montgomery multiplication of a[i].2^VSHIFT by b[i] with respect to 2^(52*VLEN) */
+/* Columns are accumulated in 64-bit lanes without carry propagation, and have room for thousands of 52-bit partial products */
+IFMA_TARGET
+static void YYY::ifma_mul_x8(FP *r,FP *a,FP *b)
+{
+    int i,j;
+    BIG t;
+    unsign64 x[8*VLEN_YYY],y[8*VLEN_YYY],z[8*(VLEN_YYY+1)],m[VLEN_YYY],minv;
+    __m512i X,Q,Y[VLEN_YYY],M[VLEN_YYY],T[2*VLEN_YYY+1],zero,mask,mc;
+
+    BIG_rcopy(t,Modulus);
+    ifma_pack(m,1,t,0);
+    minv=m[0];                  /* 1/p mod 2^64 by Newton iteration */
+    for (i=0; i<5; i++) minv*=2-m[0]*minv;
+    minv=(0-minv)&VMASK_YYY;    /* -1/p mod 2^52 */
+
+    for (i=0; i<8; i++)
+    {
+        BIG_copy(t,a[i].g);
+        BIG_norm(t);
+        ifma_pack(&x[i],8,t,VSHIFT_YYY);
+        BIG_copy(t,b[i].g);
+        BIG_norm(t);
+        ifma_pack(&y[i],8,t,0);
+    }
+
+    zero=_mm512_setzero_si512();
+    mask=_mm512_set1_epi64(VMASK_YYY);
+    mc=_mm512_set1_epi64(minv);
+    for (i=0; i<VLEN_YYY; i++)
+    {
+        Y[i]=_mm512_loadu_si512(&y[8*i]);
+        M[i]=_mm512_set1_epi64(m[i]);
+    }
+    for (i=0; i<=2*VLEN_YYY; i++) T[i]=zero;
+
+    for (i=0; i<VLEN_YYY; i++)
+    {
+        X=_mm512_loadu_si512(&x[8*i]);
+        for (j=0; j<VLEN_YYY; j++)
+        {
+            T[i+j]=_mm512_madd52lo_epu64(T[i+j],X,Y[j]);
+            T[i+j+1]=_mm512_madd52hi_epu64(T[i+j+1],X,Y[j]);
+        }
+    }
+    for (i=0; i<VLEN_YYY; i++)
+    {   /* low 52 bits of T[i] are exact, as the carry from T[i-1] has been added in */
+        Q=_mm512_madd52lo_epu64(zero,T[i],mc);
+        for (j=0; j<VLEN_YYY; j++)
+        {
+            T[i+j]=_mm512_madd52lo_epu64(T[i+j],Q,M[j]);
+            T[i+j+1]=_mm512_madd52hi_epu64(T[i+j+1],Q,M[j]);
+        }
+        T[i+1]=_mm512_add_epi64(T[i+1],_mm512_srli_epi64(T[i],52));
+    }
+    for (i=VLEN_YYY; i<2*VLEN_YYY; i++)
+    {
+        T[i+1]=_mm512_add_epi64(T[i+1],_mm512_srli_epi64(T[i],52));
+        T[i]=_mm512_and_si512(T[i],mask);
+    }
+    for (i=0; i<=VLEN_YYY; i++)
+        _mm512_storeu_si512(&z[8*i],T[VLEN_YYY+i]);
+
+    for (i=0; i<8; i++)
+        ifma_unpack(r[i].g,&z[i],8,VLEN_YYY+1);
+}
+
+#endif
+
+/* r[i]=a[i]*b[i] mod Modulus for i=0..7 */
+void YYY::FP_mul_x8(FP *r,FP *a,FP *b)
+{
+    int i;
+#ifdef IFMA_YYY
+    for (i=0; i<8; i++)
+    {
+        if ((sign64)a[i].XES*b[i].XES>(sign64)FEXCESS_YYY)
+            FP_reduce(&a[i]);
+    }
+    ifma_mul_x8(r,a,b);
+    for (i=0; i<8; i++)
+        r[i].XES=2;
+#else
+    for (i=0; i<8; i++)
+        FP_mul(&r[i],&a[i],&b[i]);
+#endif
+}
 
 /* multiplication by an integer, r=a*c */
 /* SU= 136 */
@@ -645,25 +804,6 @@ void YYY::FP_fpow(FP *r,FP *x)
 
 }
 
-void YYY::FP_inv(FP *r,FP *x)
-{
-	FP y,t;
-	FP_fpow(&y,x);
-    if (MOD8_YYY==5)
-    { // r=x^3.y^8
-		FP_sqr(&t,x);
-		FP_mul(&t,&t,x);
-		FP_sqr(&y,&y);
-		FP_sqr(&y,&y);
-		FP_sqr(&y,&y);
-		FP_mul(r,&t,&y);
-	} else {
-		FP_sqr(&y,&y);
-		FP_sqr(&y,&y);
-		FP_mul(r,&y,x);
-	}
-}
-
 #else
 
 void YYY::FP_pow(FP *r,FP *a,BIG b)
@@ -703,17 +843,49 @@ void YYY::FP_pow(FP *r,FP *a,BIG b)
     FP_reduce(r);
 }
 
+#endif
+
 /* set w=1/x */
 void YYY::FP_inv(FP *w,FP *x)
 {
- 	BIG m2;
-	BIG_rcopy(m2,Modulus);
-	BIG_dec(m2,2);
-	BIG_norm(m2);
-	FP_pow(w,x,m2);
+	BIG m,b;
+	BIG_rcopy(m,Modulus);
+	FP_redc(b,x);
+	BIG_invmodp(b,b,m);
+	FP_nres(w,b);
 }
 
-#endif
+/* Set w[i]=1/x[i] for i=0 to n-1, using just one inversion */
+/* w[i] first holds product of x[0]..x[i-1]. Zeros are skipped and map to 0 */
+void YYY::FP_inv_batch(FP *w,FP *x,int n)
+{
+	int i,z;
+	FP acc,t,one,zero;
+	if (n<=0) return;
+	FP_one(&one);
+	FP_zero(&zero);
+
+	FP_copy(&acc,&one);
+	for (i=0;i<n;i++)
+	{
+		FP_copy(&w[i],&acc);
+		FP_copy(&t,&x[i]);
+		FP_cmove(&t,&one,FP_iszilch(&x[i]));
+		FP_mul(&acc,&acc,&t);
+	}
+
+	FP_inv(&acc,&acc);
+
+	for (i=n-1;i>=0;i--)
+	{
+		FP_copy(&t,&x[i]);
+		z=FP_iszilch(&x[i]);
+		FP_cmove(&t,&one,z);
+		FP_mul(&w[i],&w[i],&acc);
+		FP_mul(&acc,&acc,&t);
+		FP_cmove(&w[i],&zero,z);
+	}
+}
 
 /* SU=8 */
 /* set n=1 */
@@ -733,53 +905,67 @@ int YYY::FP_qr(FP *r)
     BIG m;
 	BIG b;
     BIG_rcopy(m,Modulus);
-    FP_redc(b,r);
+    BIG_copy(b,r->g);
     j=BIG_jacobi(b,m);
-    FP_nres(r,b);
+#if MODTYPE_YYY == NOT_SPECIAL || MODTYPE_YYY == MONTGOMERY_FRIENDLY
+/* r is held as a.R where R=2^(NLEN*BASEBITS), so correct by (2/p)^(NLEN*BASEBITS) rather than converting back */
+    if ((NLEN_XXX*BASEBITS_XXX)%2==1 && (MOD8_YYY==3 || MOD8_YYY==5)) j=-j;
+#endif
     if (j==1) return 1;
     return 0;
 
 }
 
-/* Set a=sqrt(b) mod Modulus */
-/* SU= 160 */
-void YYY::FP_sqrt(FP *r,FP *a)
+/* Set i=1/sqrt(a) and s=sqrt(a) mod Modulus from a single exponentiation. Returns 1 if a is a non-zero QR, else 0 */
+int YYY::FP_invsqrt(FP *i,FP *s,FP *a)
 {
-	FP v,i;
+	FP w,v,t,one;
     BIG b;
-    BIG m;
-    BIG_rcopy(m,Modulus);
-    BIG_mod(a->g,m);
-    BIG_copy(b,m);
+    BIG_rcopy(b,Modulus);
+    FP_copy(&w,a);
+    FP_reduce(&w);
+    FP_one(&one);
     if (MOD8_YYY==5)
     {
-        FP_copy(&i,a);
-        BIG_fshl(i.g,1);
+        FP_add(&t,&w,&w);
 #if MODTYPE_YYY == PSEUDO_MERSENNE   || MODTYPE_YYY==GENERALISED_MERSENNE
-		FP_fpow(&v,&i);
+		FP_fpow(&v,&t);
 #else
         BIG_dec(b,5);
         BIG_norm(b);
         BIG_fshr(b,3); /* (p-5)/8 */
-        FP_pow(&v,&i,b);
+        FP_pow(&v,&t,b);
 #endif
-        FP_mul(&i,&i,&v);
-        FP_mul(&i,&i,&v);
-        BIG_dec(i.g,1);
-        FP_mul(r,a,&v);
-        FP_mul(r,r,&i);
-        FP_reduce(r);
+        FP_mul(&t,&t,&v);
+        FP_mul(&t,&t,&v);
+        FP_sub(&t,&t,&one);
+        FP_norm(&t);
+        FP_mul(i,&v,&t);
+        FP_mul(s,&w,i);
     }
     if (MOD8_YYY==3 || MOD8_YYY==7)
     {
 #if MODTYPE_YYY == PSEUDO_MERSENNE   || MODTYPE_YYY==GENERALISED_MERSENNE
-		FP_fpow(r,a);
-		FP_mul(r,r,a);
+		FP_fpow(&v,&w);
 #else
-        BIG_inc(b,1);
+        BIG_dec(b,3);
         BIG_norm(b);
-        BIG_fshr(b,2); /* (p+1)/4 */
-        FP_pow(r,a,b);
+        BIG_fshr(b,2); /* (p-3)/4 */
+        FP_pow(&v,&w,b);
 #endif
+        FP_copy(i,&v);
+        FP_mul(s,&w,&v);
     }
+    FP_reduce(i);
+    FP_reduce(s);
+    FP_mul(&t,i,s);
+    return FP_equals(&t,&one);
+}
+
+/* Set a=sqrt(b) mod Modulus */
+/* SU= 160 */
+void YYY::FP_sqrt(FP *r,FP *a)
+{
+	FP i;
+    FP_invsqrt(&i,r,a);
 }
@@ -32,7 +32,8 @@ extern const chunk MConst;		/**< Constant associated with Modulus - for Montgome
 extern const XXX::BIG Fra; /**< real part of BN curve Frobenius Constant */
 extern const XXX::BIG Frb; /**< imaginary part of BN curve Frobenius Constant */
 
-//#define FUSED_MODMUL
+//#define FUSED_MODMUL_YYY  /**< Fused multiplication and Montgomery reduction - set by config script if faster */
+//#define IFMA_YYY  /**< AVX-512 IFMA backend for FP_mul_x8 - set by config script */
 //#define DEBUG_REDUCE
 
 /* FP prototypes */
@@ -116,9 +117,25 @@ extern void FP_one(FP *x);
  */
 extern void FP_mod(XXX::BIG r,XXX::DBIG d);
 
-#ifdef FUSED_MODMUL
-extern void FP_modmul(XXX::BIG,XXX::BIG,XXX::BIG);
+#ifdef FUSED_MODMUL_YYY
+/**	@brief Fused multiplication and Montgomery reduction of two BIGs, mod Modulus
+ *
+	Generated by the config script for NOT_SPECIAL moduli. Inputs must be normalised, output normalised
+	@param r BIG number, on exit = a*b/R mod Modulus
+	@param a BIG number
+	@param b BIG number
+ */
+extern void FP_modmul(XXX::BIG r,XXX::BIG a,XXX::BIG b);
 #endif
+/**	@brief Reduces a signed sum of unreduced products to an FP
+ *
+	Used for lazy reduction in the extension fields. Each of the k products must be less than p.R in magnitude
+	Assumes the products are of FPs in Montgomery (nres) form, with excesses that FP2_dmul keeps within FEXCESS, so that d+k.p.R is positive and in range for FP_mod
+	@param r FP number, on exit = d mod Modulus
+	@param d DBIG number, a signed sum of k double length products, destroyed on exit
+	@param k number of products accumulated in d
+ */
+extern void FP_dmod(FP *r,XXX::DBIG d,int k);
 
 /**	@brief Fast Modular multiplication of two FPs, mod Modulus
  *
@@ -128,6 +145,14 @@ extern void FP_modmul(XXX::BIG,XXX::BIG,XXX::BIG);
 	@param z FP number, the multiplier
  */
 extern void FP_mul(FP *x,FP *y,FP *z);
+/**	@brief Eight independent modular multiplications of FPs, mod Modulus
+ *
+	Uses the AVX-512 IFMA backend if configured, otherwise FP_mul
+	@param x array of 8 FP numbers, on exit x[i] = y[i]*z[i] mod Modulus
+	@param y array of 8 FP numbers, the multiplicands
+	@param z array of 8 FP numbers, the multipliers
+ */
+extern void FP_mul_x8(FP *x,FP *y,FP *z);
 /**	@brief Fast Modular multiplication of an FP, by a small integer, mod Modulus
  *
 	@param x FP number, on exit the modular product = y*i mod Modulus
@@ -177,6 +202,15 @@ extern void FP_pow(FP *x,FP *y,XXX::BIG z);
 
  */
 extern void FP_sqrt(FP *x,FP *y);
+/**	@brief Modular inverse square root and square root of an FP, mod Modulus
+ *
+	Both roots are found from a single exponentiation, and a single test decides if y is a QR
+	@param i FP number, on exit  = 1/sqrt(y) mod Modulus
+	@param s FP number, on exit  = sqrt(y) mod Modulus
+	@param y FP number, the number whose square root is calculated
+	@return 1 if y is a non-zero quadratic residue, else 0
+ */
+extern int FP_invsqrt(FP *i,FP *s,FP *y);
 /**	@brief Modular negation of a an FP, mod Modulus
  *
 	@param x FP number, on exit = -y mod Modulus
@@ -216,6 +250,14 @@ extern int FP_qr(FP *x);
 	@param y FP number
  */
 extern void FP_inv(FP *x,FP *y);
+/**	@brief Simultaneous modular inversion of n FPs, mod Modulus
+ *
+	Uses Montgomery's trick - one inversion plus 3(n-1) modular multiplications. Zero elements are mapped to zero
+	@param x array of n FPs, on exit x[i] = 1/y[i] mod Modulus. Must be distinct from y
+	@param y array of n FPs
+	@param n number of elements
+ */
+extern void FP_inv_batch(FP *x,FP *y,int n);
 
 /**	@brief Special exponent of an FP, mod Modulus
  *
@@ -478,98 +478,103 @@ void YYY::FP12_ssmul(FP12 *w,FP12 *y)
 /* w and y are both sparser line functions - cost = 6m */ 
 void YYY::FP12_smul(FP12 *w,FP12 *y)
 {
-	FP2 w1,w2,w3,ta,tb,tc,td,te,t;
+	DBIG A0,A1,B0,B1,C0,C1,E0,E1,T;
+	FP2 w1,w3,ta,tb,tc,td,te;
 
 //	if (type==D_TYPE)
 //	{ 
 #if SEXTIC_TWIST_ZZZ == D_TYPE
-	FP2_mul(&w1,&(w->a).a,&(y->a).a); // A1.A2
-	FP2_mul(&w2,&(w->a).b,&(y->a).b); // B1.B2
-	FP2_mul(&w3,&(w->b).a,&(y->b).a); // C1.C2
+	FP2_dmul(A0,A1,&(w->a).a,&(y->a).a); // A1.A2
+	FP2_dmul(B0,B1,&(w->a).b,&(y->a).b); // B1.B2
+	FP2_dmul(C0,C1,&(w->b).a,&(y->b).a); // C1.C2
 
 	FP2_add(&ta,&(w->a).a,&(w->a).b); // A1+B1
 	FP2_add(&tb,&(y->a).a,&(y->a).b); // A2+B2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&tc,&ta,&tb);			// (A1+B1)(A2+B2)
-	FP2_add(&t,&w1,&w2);
-	FP2_neg(&t,&t);
-	FP2_add(&tc,&tc,&t);			// (A1+B1)(A2+B2)-A1.A2-B1*B2 =  (A1.B2+A2.B1)		
+	FP2_dmul(E0,E1,&ta,&tb);		// (A1+B1)(A2+B2)
+	BIG_dsub(E0,E0,A0); BIG_dsub(E0,E0,B0);
+	BIG_dsub(E1,E1,A1); BIG_dsub(E1,E1,B1);
+	FP2_dmod(&tc,E0,E1,3);			// (A1+B1)(A2+B2)-A1.A2-B1*B2 =  (A1.B2+A2.B1)		
 				
 	FP2_add(&ta,&(w->a).a,&(w->b).a); // A1+C1
 	FP2_add(&tb,&(y->a).a,&(y->b).a); // A2+C2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&td,&ta,&tb);			// (A1+C1)(A2+C2)
-	FP2_add(&t,&w1,&w3);
-	FP2_neg(&t,&t);
-	FP2_add(&td,&td,&t);			// (A1+C1)(A2+C2)-A1.A2-C1*C2 =  (A1.C2+A2.C1)		
+	FP2_dmul(E0,E1,&ta,&tb);		// (A1+C1)(A2+C2)
+	BIG_dsub(E0,E0,A0); BIG_dsub(E0,E0,C0);
+	BIG_dsub(E1,E1,A1); BIG_dsub(E1,E1,C1);
+	FP2_dmod(&td,E0,E1,3);			// (A1+C1)(A2+C2)-A1.A2-C1*C2 =  (A1.C2+A2.C1)		
 
 	FP2_add(&ta,&(w->a).b,&(w->b).a); // B1+C1
 	FP2_add(&tb,&(y->a).b,&(y->b).a); // B2+C2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&te,&ta,&tb);			// (B1+C1)(B2+C2)
-	FP2_add(&t,&w2,&w3);
-	FP2_neg(&t,&t);
-	FP2_add(&te,&te,&t);			// (B1+C1)(B2+C2)-B1.B2-C1*C2 =  (B1.C2+B2.C1)		
+	FP2_dmul(E0,E1,&ta,&tb);		// (B1+C1)(B2+C2)
+	BIG_dsub(E0,E0,B0); BIG_dsub(E0,E0,C0);
+	BIG_dsub(E1,E1,B1); BIG_dsub(E1,E1,C1);
+	FP2_dmod(&te,E0,E1,3);			// (B1+C1)(B2+C2)-B1.B2-C1*C2 =  (B1.C2+B2.C1)		
+
+	BIG_dsub(T,B0,B1);				// (1+i).B1.B2
+	BIG_dadd(B1,B0,B1);
+	BIG_dadd(A0,A0,T);
+	BIG_dadd(A1,A1,B1);
+	FP2_dmod(&w1,A0,A1,3);			// A1.A2+(1+i).B1.B2
+	FP2_dmod(&w3,C0,C1,1);
 
-	FP2_mul_ip(&w2);
-	FP2_add(&w1,&w1,&w2);
 	FP4_from_FP2s(&(w->a),&w1,&tc);
-	FP4_from_FP2s(&(w->b),&td,&te); // only norm these 2
+	FP4_from_FP2s(&(w->b),&td,&te);
 	FP4_from_FP2(&(w->c),&w3);
-
-	FP4_norm(&(w->a));
-	FP4_norm(&(w->b));
 #endif
 //	} else { 
 #if SEXTIC_TWIST_ZZZ == M_TYPE
-	FP2_mul(&w1,&(w->a).a,&(y->a).a); // A1.A2
-	FP2_mul(&w2,&(w->a).b,&(y->a).b); // B1.B2
-	FP2_mul(&w3,&(w->c).b,&(y->c).b); // F1.F2
+	FP2_dmul(A0,A1,&(w->a).a,&(y->a).a); // A1.A2
+	FP2_dmul(B0,B1,&(w->a).b,&(y->a).b); // B1.B2
+	FP2_dmul(C0,C1,&(w->c).b,&(y->c).b); // F1.F2
 
 	FP2_add(&ta,&(w->a).a,&(w->a).b); // A1+B1
 	FP2_add(&tb,&(y->a).a,&(y->a).b); // A2+B2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&tc,&ta,&tb);			// (A1+B1)(A2+B2)
-	FP2_add(&t,&w1,&w2);
-	FP2_neg(&t,&t);
-	FP2_add(&tc,&tc,&t);			// (A1+B1)(A2+B2)-A1.A2-B1*B2 =  (A1.B2+A2.B1)		
+	FP2_dmul(E0,E1,&ta,&tb);		// (A1+B1)(A2+B2)
+	BIG_dsub(E0,E0,A0); BIG_dsub(E0,E0,B0);
+	BIG_dsub(E1,E1,A1); BIG_dsub(E1,E1,B1);
+	FP2_dmod(&tc,E0,E1,3);			// (A1+B1)(A2+B2)-A1.A2-B1*B2 =  (A1.B2+A2.B1)		
 				
 	FP2_add(&ta,&(w->a).a,&(w->c).b); // A1+F1
 	FP2_add(&tb,&(y->a).a,&(y->c).b); // A2+F2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&td,&ta,&tb);			// (A1+F1)(A2+F2)
-	FP2_add(&t,&w1,&w3);
-	FP2_neg(&t,&t);
-	FP2_add(&td,&td,&t);			// (A1+F1)(A2+F2)-A1.A2-F1*F2 =  (A1.F2+A2.F1)		
+	FP2_dmul(E0,E1,&ta,&tb);		// (A1+F1)(A2+F2)
+	BIG_dsub(E0,E0,A0); BIG_dsub(E0,E0,C0);
+	BIG_dsub(E1,E1,A1); BIG_dsub(E1,E1,C1);
+	FP2_dmod(&td,E0,E1,3);			// (A1+F1)(A2+F2)-A1.A2-F1*F2 =  (A1.F2+A2.F1)		
 
 	FP2_add(&ta,&(w->a).b,&(w->c).b); // B1+F1
 	FP2_add(&tb,&(y->a).b,&(y->c).b); // B2+F2
 	FP2_norm(&ta);
 	FP2_norm(&tb);
-	FP2_mul(&te,&ta,&tb);			// (B1+F1)(B2+F2)
-	FP2_add(&t,&w2,&w3);
-	FP2_neg(&t,&t);
-	FP2_add(&te,&te,&t);			// (B1+F1)(B2+F2)-B1.B2-F1*F2 =  (B1.F2+B2.F1)	
+	FP2_dmul(E0,E1,&ta,&tb);		// (B1+F1)(B2+F2)
+	BIG_dsub(E0,E0,B0); BIG_dsub(E0,E0,C0);
+	BIG_dsub(E1,E1,B1); BIG_dsub(E1,E1,C1);
+	BIG_dnorm(E0); BIG_dnorm(E1);	// (B1+F1)(B2+F2)-B1.B2-F1*F2 =  (B1.F2+B2.F1)	
+	BIG_dsub(T,E0,E1);
+	BIG_dadd(E1,E0,E1);
+	FP2_dmod(&te,T,E1,6);			// (1+i)(B1.F2+B2.F1)
+
+	BIG_dsub(T,B0,B1);				// (1+i).B1.B2
+	BIG_dadd(B1,B0,B1);
+	BIG_dadd(A0,A0,T);
+	BIG_dadd(A1,A1,B1);
+	FP2_dmod(&w1,A0,A1,3);			// A1.A2+(1+i).B1.B2
+
+	BIG_dsub(T,C0,C1);				// (1+i).F1.F2
+	BIG_dadd(C1,C0,C1);
+	FP2_dmod(&w3,T,C1,2);
 
-	FP2_mul_ip(&w2);
-	FP2_add(&w1,&w1,&w2);
 	FP4_from_FP2s(&(w->a),&w1,&tc);
-
-	FP2_mul_ip(&w3);
-	FP2_norm(&w3);
 	FP4_from_FP2H(&(w->b),&w3);
-
-	FP2_norm(&te);
-	FP2_mul_ip(&te);
 	FP4_from_FP2s(&(w->c),&te,&td);
-
-	FP4_norm(&(w->a));
-	FP4_norm(&(w->c));
 #endif
 
 //	}
@@ -721,6 +726,189 @@ void YYY::FP12_pow(FP12 *r,FP12 *a,BIG b)
 
 }
 
+/* Karabina's compressed squaring, eprint 2010/542 */
+/* An element of the cyclotomic subgroup is determined by g=(g2,g3,g4,g5), where a=g0+g1.j, b=g2+g3.j, c=g4+g5.j and j is the generator of FP4 over FP2 */
+/* g0 and g1 are recovered from the fact that the norm of x is 1 */
+
+#define UPOW_BATCH 8 /* maximum number of compressed powers sharing one inversion */
+
+/* g=g^2 in compressed form */
+/* h2=2(g2+3.xi.g4.g5), h3=3(g4^2+xi.g5^2)-2.g3, h4=3(g2^2+xi.g3^2)-2.g4, h5=2(g5+3.g2.g3) */
+static void FP12_csqr(YYY::FP2 g[4])
+{
+	YYY::FP2 A,B,C,D,E,F;
+
+	FP2_sqr(&A,&g[0]);
+	FP2_sqr(&B,&g[1]);
+	FP2_sqr(&C,&g[2]);
+	FP2_sqr(&D,&g[3]);
+	FP2_mul(&E,&g[0],&g[1]);
+	FP2_mul(&F,&g[2],&g[3]);
+
+	FP2_mul_ip(&B);
+	FP2_add(&A,&A,&B);     // g2^2+xi.g3^2
+	FP2_mul_ip(&D);
+	FP2_add(&C,&C,&D);     // g4^2+xi.g5^2
+	FP2_mul_ip(&F);        // xi.g4.g5
+	FP2_norm(&A);
+	FP2_norm(&C);
+	FP2_norm(&F);
+
+	FP2_add(&B,&C,&C);
+	FP2_add(&C,&B,&C);
+	FP2_add(&B,&g[1],&g[1]);
+	FP2_norm(&C);
+	FP2_norm(&B);
+	FP2_sub(&g[1],&C,&B);
+
+	FP2_add(&B,&A,&A);
+	FP2_add(&A,&B,&A);
+	FP2_add(&B,&g[2],&g[2]);
+	FP2_norm(&A);
+	FP2_norm(&B);
+	FP2_sub(&g[2],&A,&B);
+
+	FP2_add(&B,&F,&F);
+	FP2_add(&B,&B,&F);
+	FP2_add(&B,&B,&g[0]);
+	FP2_norm(&B);
+	FP2_add(&g[0],&B,&B);
+
+	FP2_add(&B,&E,&E);
+	FP2_add(&B,&B,&E);
+	FP2_add(&B,&B,&g[3]);
+	FP2_norm(&B);
+	FP2_add(&g[3],&B,&B);
+
+	FP2_reduce(&g[0]);
+	FP2_reduce(&g[1]);
+	FP2_reduce(&g[2]);
+	FP2_reduce(&g[3]);
+}
+
+/* Recover w[i] from compressed g[i] for i=0 to n-1, with one inversion for all of them */
+/* g1=(xi.g5^2+3.g4^2-2.g3)/4.g2, or 2.g4.g5/g3 if g2=0. Then g0=xi.(2.g1^2+g2.g5-3.g3.g4)+1 */
+static void FP12_decompress(YYY::FP12 *w,YYY::FP2 g[][4],int n)
+{
+	int i;
+	YYY::FP2 A,B,C,one,N[UPOW_BATCH],D[UPOW_BATCH],ID[UPOW_BATCH];
+
+	for (i=0; i<n; i++)
+	{
+		if (FP2_iszilch(&g[i][0]))
+		{
+			FP2_mul(&N[i],&g[i][2],&g[i][3]);
+			FP2_add(&N[i],&N[i],&N[i]);
+			FP2_copy(&D[i],&g[i][1]);
+		}
+		else
+		{
+			FP2_sqr(&A,&g[i][3]);
+			FP2_mul_ip(&A);
+			FP2_sqr(&B,&g[i][2]);
+			FP2_add(&C,&B,&B);
+			FP2_add(&B,&B,&C);
+			FP2_norm(&A);
+			FP2_norm(&B);
+			FP2_add(&A,&A,&B);
+			FP2_add(&B,&g[i][1],&g[i][1]);
+			FP2_norm(&A);
+			FP2_norm(&B);
+			FP2_sub(&N[i],&A,&B);
+			FP2_add(&D[i],&g[i][0],&g[i][0]);
+			FP2_add(&D[i],&D[i],&D[i]);
+		}
+		FP2_norm(&N[i]);
+		FP2_norm(&D[i]);
+	}
+
+	FP2_inv_batch(ID,D,n);
+
+	FP2_one(&one);
+	for (i=0; i<n; i++)
+	{
+		FP2_mul(&B,&N[i],&ID[i]);       // g1
+		FP2_sqr(&A,&B);
+		FP2_add(&A,&A,&A);
+		FP2_mul(&C,&g[i][0],&g[i][3]);
+		FP2_add(&A,&A,&C);
+		FP2_mul(&C,&g[i][1],&g[i][2]);
+		FP2_add(&D[i],&C,&C);
+		FP2_add(&C,&C,&D[i]);
+		FP2_norm(&A);
+		FP2_norm(&C);
+		FP2_sub(&A,&A,&C);
+		FP2_norm(&A);
+		FP2_mul_ip(&A);
+		FP2_add(&A,&A,&one);         // g0
+		FP2_norm(&A);
+
+		FP4_from_FP2s(&(w[i].a),&A,&B);
+		FP4_from_FP2s(&(w[i].b),&g[i][0],&g[i][1]);
+		FP4_from_FP2s(&(w[i].c),&g[i][2],&g[i][3]);
+		w[i].type=FP_DENSE;
+	}
+}
+
+/* r=a^b for a in the cyclotomic subgroup, as after the easy part of the final exponentiation */
+/* The squarings are done in compressed form, and only the powers that are multiplied in are decompressed */
+/* Not side-channel safe, like FP12_pow */
+
+void YYY::FP12_upow(FP12 *r,FP12 *a,BIG b)
+{
+	int i,j,k,nb,bt,s[UPOW_BATCH];
+	BIG b1,b3;
+	FP2 g[4],c[UPOW_BATCH][4];
+	FP12 sf,w[UPOW_BATCH];
+
+	BIG_copy(b1,b);
+	BIG_norm(b1);
+	BIG_pmul(b3,b1,3);
+	BIG_norm(b3);
+	FP12_copy(&sf,a);
+	FP12_reduce(&sf);
+	FP12_one(r);
+
+	FP2_copy(&g[0],&(sf.b.a));
+	FP2_copy(&g[1],&(sf.b.b));
+	FP2_copy(&g[2],&(sf.c.a));
+	FP2_copy(&g[3],&(sf.c.b));
+
+	/* digit i of b has weight 2^(i-1), and g holds a^(2^(i-1)) */
+	nb=BIG_nbits(b3);
+	k=0;
+	for (i=1; i<nb; i++)
+	{
+		bt=BIG_bit(b3,i)-BIG_bit(b1,i);
+		if (bt!=0)
+		{
+			if (i==1)
+			{
+				FP12_copy(r,&sf);
+				if (bt<0) FP12_conj(r,r);
+			}
+			else
+			{
+				for (j=0; j<4; j++)
+					FP2_copy(&c[k][j],&g[j]);
+				s[k++]=bt;
+			}
+		}
+		if (k==UPOW_BATCH || (k>0 && i==nb-1))
+		{
+			FP12_decompress(w,c,k);
+			for (j=0; j<k; j++)
+			{
+				if (s[j]<0) FP12_conj(&w[j],&w[j]);
+				FP12_mul(r,&w[j]);
+			}
+			k=0;
+		}
+		if (i<nb-1) FP12_csqr(g);
+	}
+	FP12_reduce(r);
+}
+
 
 /* p=q0^u0.q1^u1.q2^u2.q3^u3 */
 /* Side channel attack secure */
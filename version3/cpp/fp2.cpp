@@ -252,6 +252,50 @@ void YYY::FP2_mul(FP2 *w,FP2 *x,FP2 *y)
 //	YYY::fp2muls++;
 }
 
+/* Set a+ib=x*y, with no reduction */
+/* Inputs MUST be normed  */
+/* Outputs are signed and normed, |a|,|b| < pR */
+void YYY::FP2_dmul(DBIG a,DBIG b,FP2 *x,FP2 *y)
+{
+	DBIG A,B;
+	BIG C,D;
+
+	if ((sign64)(x->a.XES+x->b.XES)*(y->a.XES+y->b.XES)>(sign64)FEXCESS_YYY)
+	{
+#ifdef DEBUG_REDUCE
+		printf("FP2 Product too large - reducing it\n");
+#endif
+		if (x->a.XES>1) FP_reduce(&(x->a));
+        if (x->b.XES>1) FP_reduce(&(x->b));        
+    }
+	if ((sign64)(x->a.XES+x->b.XES)*(y->a.XES+y->b.XES)>(sign64)FEXCESS_YYY)
+	{
+		if (y->a.XES>1) FP_reduce(&(y->a));
+        if (y->b.XES>1) FP_reduce(&(y->b));        
+	}
+
+	BIG_mul(A,x->a.g,y->a.g);
+	BIG_mul(B,x->b.g,y->b.g);
+
+	BIG_add(C,x->a.g,x->b.g); BIG_norm(C);
+	BIG_add(D,y->a.g,y->b.g); BIG_norm(D);
+
+	BIG_mul(b,C,D);
+	BIG_dsub(b,b,A);
+	BIG_dsub(b,b,B);	// b=x.a*y.b+x.b*y.a
+	BIG_dsub(a,A,B);	// a=x.a*y.a-x.b*y.b
+
+	BIG_dnorm(a);
+	BIG_dnorm(b);
+}
+
+/* Set w=a+ib mod p, where a and b are signed sums of k products */
+void YYY::FP2_dmod(FP2 *w,DBIG a,DBIG b,int k)
+{
+	FP_dmod(&(w->a),a,k);
+	FP_dmod(&(w->b),b,k);
+}
+
 /* output FP2 in hex format [a,b] */
 /* SU= 16 */
 void YYY::FP2_output(FP2 *w)
@@ -300,6 +344,40 @@ void YYY::FP2_inv(FP2 *w,FP2 *x)
     FP_mul(&(w->b),&(x->b),&w1);
 }
 
+/* Set w[i]=1/x[i] for i=0 to n-1, using just one inversion */
+/* Zeros are skipped and map to 0 */
+void YYY::FP2_inv_batch(FP2 *w,FP2 *x,int n)
+{
+	int i,z;
+	FP2 acc,t,one,zero;
+	if (n<=0) return;
+	FP2_one(&one);
+	FP2_zero(&zero);
+
+	FP2_copy(&acc,&one);
+	for (i=0;i<n;i++)
+	{
+		FP2_copy(&w[i],&acc);
+		FP2_copy(&t,&x[i]);
+		FP2_norm(&t);
+		FP2_cmove(&t,&one,FP2_iszilch(&t));
+		FP2_mul(&acc,&acc,&t);
+	}
+
+	FP2_inv(&acc,&acc);
+
+	for (i=n-1;i>=0;i--)
+	{
+		FP2_copy(&t,&x[i]);
+		FP2_norm(&t);
+		z=FP2_iszilch(&t);
+		FP2_cmove(&t,&one,z);
+		FP2_mul(&w[i],&w[i],&acc);
+		FP2_mul(&acc,&acc,&t);
+		FP2_cmove(&w[i],&zero,z);
+	}
+}
+
 
 /* Set w=x/2 */
 /* SU= 16 */
@@ -390,41 +468,36 @@ void YYY::FP2_pow(FP2 *r,FP2* a,BIG b)
 
 int YYY::FP2_sqrt(FP2 *w,FP2 *u)
 {
-    BIG b;
-	FP w1,w2;
+	FP w1,w2,w3;
     FP2_copy(w,u);
     if (FP2_iszilch(w)) return 1;
 
     FP_sqr(&w1,&(w->b));
     FP_sqr(&w2,&(w->a));
     FP_add(&w1,&w1,&w2);
-    if (!FP_qr(&w1))
+    if (!FP_invsqrt(&w3,&w1,&w1))
     {
         FP2_zero(w);
         return 0;
     }
-    FP_sqrt(&w1,&w1);
     FP_add(&w2,&(w->a),&w1);
 	FP_norm(&w2);
     FP_div2(&w2,&w2);
-    if (!FP_qr(&w2))
+    if (!FP_invsqrt(&w3,&w2,&w2))
     {
         FP_sub(&w2,&(w->a),&w1);
 		FP_norm(&w2);
         FP_div2(&w2,&w2);
-        if (!FP_qr(&w2))
+        if (!FP_invsqrt(&w3,&w2,&w2))
         {
             FP2_zero(w);
             return 0;
         }
     }
-    FP_sqrt(&w2,&w2);
     FP_copy(&(w->a),&w2);
-    FP_add(&w2,&w2,&w2);
-
-	FP_inv(&w2,&w2);
+    FP_div2(&w3,&w3);
 
-    FP_mul(&(w->b),&(w->b),&w2);
+    FP_mul(&(w->b),&(w->b),&w3);
     return 1;
 }
 
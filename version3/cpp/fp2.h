@@ -144,6 +144,23 @@ extern void FP2_sqr(FP2 *x,FP2 *y);
 	@param z FP2 instance
  */
 extern void FP2_mul(FP2 *x,FP2 *y,FP2 *z);
+/**	@brief Unreduced multiplication of two FP2s
+ *
+	For lazy reduction. Products are accumulated as DBIGs, and reduced later using FP_dmod
+	@param a DBIG, on exit = real part of y*z, signed, |a| < p.R
+	@param b DBIG, on exit = imaginary part of y*z, |b| < p.R
+	@param y FP2 instance, must be normed
+	@param z FP2 instance, must be normed
+ */
+extern void FP2_dmul(XXX::DBIG a,XXX::DBIG b,FP2 *y,FP2 *z);
+/**	@brief Reduces an unreduced FP2, each part a signed sum of k products
+ *
+	@param x FP2 instance, on exit = a+ib mod Modulus
+	@param a DBIG, real part, destroyed on exit
+	@param b DBIG, imaginary part, destroyed on exit
+	@param k number of products accumulated in a and b
+ */
+extern void FP2_dmod(FP2 *x,XXX::DBIG a,XXX::DBIG b,int k);
 /**	@brief Formats and outputs an FP2 to the console
  *
 	@param x FP2 instance
@@ -160,6 +177,14 @@ extern void FP2_rawoutput(FP2 *x);
 	@param y FP2 instance
  */
 extern void FP2_inv(FP2 *x,FP2 *y);
+/**	@brief Simultaneous inversion of n FP2s
+ *
+	Uses Montgomery's trick - one inversion plus 3(n-1) multiplications. Zero elements are mapped to zero
+	@param x array of n FP2s, on exit x[i] = 1/y[i]. Must be distinct from y
+	@param y array of n FP2s
+	@param n number of elements
+ */
+extern void FP2_inv_batch(FP2 *x,FP2 *y,int n);
 /**	@brief Divide an FP2 by 2
  *
 	@param x FP2 instance, on exit = y/2
@@ -718,6 +718,190 @@ void YYY::FP24_pow(FP24 *r,FP24 *a,BIG b)
 	FP24_reduce(r);
 }
 
+/* Karabina's compressed squaring, eprint 2010/542 */
+/* An element of the cyclotomic subgroup is determined by g=(g2,g3,g4,g5), where a=g0+g1.j, b=g2+g3.j, c=g4+g5.j and j is the generator of FP8 over FP4 */
+/* g0 and g1 are recovered from the fact that the norm of x is 1 */
+
+#define UPOW_BATCH 8 /* maximum number of compressed powers sharing one inversion */
+
+/* g=g^2 in compressed form */
+/* h2=2(g2+3.xi.g4.g5), h3=3(g4^2+xi.g5^2)-2.g3, h4=3(g2^2+xi.g3^2)-2.g4, h5=2(g5+3.g2.g3) */
+static void FP24_csqr(YYY::FP4 g[4])
+{
+	YYY::FP4 A,B,C,D,E,F;
+
+	FP4_sqr(&A,&g[0]);
+	FP4_sqr(&B,&g[1]);
+	FP4_sqr(&C,&g[2]);
+	FP4_sqr(&D,&g[3]);
+	FP4_mul(&E,&g[0],&g[1]);
+	FP4_mul(&F,&g[2],&g[3]);
+
+	FP4_times_i(&B);
+	FP4_add(&A,&A,&B);     // g2^2+xi.g3^2
+	FP4_times_i(&D);
+	FP4_add(&C,&C,&D);     // g4^2+xi.g5^2
+	FP4_times_i(&F);        // xi.g4.g5
+	FP4_norm(&A);
+	FP4_norm(&C);
+	FP4_norm(&F);
+
+	FP4_add(&B,&C,&C);
+	FP4_add(&C,&B,&C);
+	FP4_add(&B,&g[1],&g[1]);
+	FP4_norm(&C);
+	FP4_norm(&B);
+	FP4_sub(&g[1],&C,&B);
+
+	FP4_add(&B,&A,&A);
+	FP4_add(&A,&B,&A);
+	FP4_add(&B,&g[2],&g[2]);
+	FP4_norm(&A);
+	FP4_norm(&B);
+	FP4_sub(&g[2],&A,&B);
+
+	FP4_add(&B,&F,&F);
+	FP4_add(&B,&B,&F);
+	FP4_add(&B,&B,&g[0]);
+	FP4_norm(&B);
+	FP4_add(&g[0],&B,&B);
+
+	FP4_add(&B,&E,&E);
+	FP4_add(&B,&B,&E);
+	FP4_add(&B,&B,&g[3]);
+	FP4_norm(&B);
+	FP4_add(&g[3],&B,&B);
+
+	FP4_reduce(&g[0]);
+	FP4_reduce(&g[1]);
+	FP4_reduce(&g[2]);
+	FP4_reduce(&g[3]);
+}
+
+/* Recover w[i] from compressed g[i] for i=0 to n-1, with one inversion for all of them */
+/* g1=(xi.g5^2+3.g4^2-2.g3)/4.g2, or 2.g4.g5/g3 if g2=0. Then g0=xi.(2.g1^2+g2.g5-3.g3.g4)+1 */
+static void FP24_decompress(YYY::FP24 *w,YYY::FP4 g[][4],int n)
+{
+	int i;
+	YYY::FP4 A,B,C,one,N[UPOW_BATCH],D[UPOW_BATCH],ID[UPOW_BATCH];
+
+	for (i=0; i<n; i++)
+	{
+		if (FP4_iszilch(&g[i][0]))
+		{
+			FP4_mul(&N[i],&g[i][2],&g[i][3]);
+			FP4_add(&N[i],&N[i],&N[i]);
+			FP4_copy(&D[i],&g[i][1]);
+		}
+		else
+		{
+			FP4_sqr(&A,&g[i][3]);
+			FP4_times_i(&A);
+			FP4_sqr(&B,&g[i][2]);
+			FP4_add(&C,&B,&B);
+			FP4_add(&B,&B,&C);
+			FP4_norm(&A);
+			FP4_norm(&B);
+			FP4_add(&A,&A,&B);
+			FP4_add(&B,&g[i][1],&g[i][1]);
+			FP4_norm(&A);
+			FP4_norm(&B);
+			FP4_sub(&N[i],&A,&B);
+			FP4_add(&D[i],&g[i][0],&g[i][0]);
+			FP4_add(&D[i],&D[i],&D[i]);
+		}
+		FP4_norm(&N[i]);
+		FP4_norm(&D[i]);
+	}
+
+	FP4_inv_batch(ID,D,n);
+
+	FP4_one(&one);
+	for (i=0; i<n; i++)
+	{
+		FP4_mul(&B,&N[i],&ID[i]);       // g1
+		FP4_sqr(&A,&B);
+		FP4_add(&A,&A,&A);
+		FP4_mul(&C,&g[i][0],&g[i][3]);
+		FP4_add(&A,&A,&C);
+		FP4_mul(&C,&g[i][1],&g[i][2]);
+		FP4_add(&D[i],&C,&C);
+		FP4_add(&C,&C,&D[i]);
+		FP4_norm(&A);
+		FP4_norm(&C);
+		FP4_sub(&A,&A,&C);
+		FP4_norm(&A);
+		FP4_times_i(&A);
+		FP4_add(&A,&A,&one);         // g0
+		FP4_norm(&A);
+
+		FP8_from_FP4s(&(w[i].a),&A,&B);
+		FP8_from_FP4s(&(w[i].b),&g[i][0],&g[i][1]);
+		FP8_from_FP4s(&(w[i].c),&g[i][2],&g[i][3]);
+		w[i].type=FP_DENSE;
+	}
+}
+
+/* r=a^b for a in the cyclotomic subgroup, as after the easy part of the final exponentiation */
+/* The squarings are done in compressed form, and only the powers that are multiplied in are decompressed */
+/* Not side-channel safe, like FP24_pow */
+
+void YYY::FP24_upow(FP24 *r,FP24 *a,BIG b)
+{
+	int i,j,k,nb,bt,s[UPOW_BATCH];
+	BIG b1,b3;
+	FP4 g[4],c[UPOW_BATCH][4];
+	FP24 sf,w[UPOW_BATCH];
+
+	BIG_copy(b1,b);
+	BIG_norm(b1);
+	BIG_pmul(b3,b1,3);
+	BIG_norm(b3);
+	FP24_copy(&sf,a);
+	FP24_reduce(&sf);
+	FP24_one(r);
+
+	FP4_copy(&g[0],&(sf.b.a));
+	FP4_copy(&g[1],&(sf.b.b));
+	FP4_copy(&g[2],&(sf.c.a));
+	FP4_copy(&g[3],&(sf.c.b));
+
+	/* digit i of b has weight 2^(i-1), and g holds a^(2^(i-1)) */
+	nb=BIG_nbits(b3);
+	k=0;
+	for (i=1; i<nb; i++)
+	{
+		bt=BIG_bit(b3,i)-BIG_bit(b1,i);
+		if (bt!=0)
+		{
+			if (i==1)
+			{
+				FP24_copy(r,&sf);
+				if (bt<0) FP24_conj(r,r);
+			}
+			else
+			{
+				for (j=0; j<4; j++)
+					FP4_copy(&c[k][j],&g[j]);
+				s[k++]=bt;
+			}
+		}
+		if (k==UPOW_BATCH || (k>0 && i==nb-1))
+		{
+			FP24_decompress(w,c,k);
+			for (j=0; j<k; j++)
+			{
+				if (s[j]<0) FP24_conj(&w[j],&w[j]);
+				FP24_mul(r,&w[j]);
+			}
+			k=0;
+		}
+		if (i<nb-1) FP24_csqr(g);
+	}
+	FP24_reduce(r);
+}
+
+
 /* p=q0^u0.q1^u1.q2^u2.q3^u3... */
 /* Side channel attack secure */
 // Bos & Costello https://eprint.iacr.org/2013/458.pdf
@@ -228,33 +228,34 @@ void YYY::FP4_sqr(FP4 *w,FP4 *x)
 
 /* Set w=x*y */
 /* Inputs MUST be normed  */
+/* Uses Lazy reduction - one reduction per coefficient */
 void YYY::FP4_mul(FP4 *w,FP4 *x,FP4 *y)
 {
+	DBIG A0,A1,B0,B1,E0,E1,T;
+    FP2 t3,t4;
 
-    FP2 t1,t2,t3,t4;
+    FP2_dmul(A0,A1,&(x->a),&(y->a));	/* xa.ya */
+    FP2_dmul(B0,B1,&(x->b),&(y->b));	/* xb.yb */
 
-    FP2_mul(&t1,&(x->a),&(y->a)); 
-
-    FP2_mul(&t2,&(x->b),&(y->b)); 
     FP2_add(&t3,&(y->b),&(y->a));
     FP2_add(&t4,&(x->b),&(x->a));
 
 	FP2_norm(&t4); // 2
 	FP2_norm(&t3); // 2
 
-    FP2_mul(&t4,&t4,&t3); /* (xa+xb)(ya+yb) */
-
-	FP2_neg(&t3,&t1);  // 1
-	FP2_add(&t4,&t4,&t3);  //t4E=3
-    FP2_norm(&t4);
+    FP2_dmul(E0,E1,&t4,&t3);	/* (xa+xb)(ya+yb) */
 
-	FP2_neg(&t3,&t2);  // 1
-	FP2_add(&(w->b),&t4,&t3); //wbE=3
-
-    FP2_mul_ip(&t2);
-    FP2_add(&(w->a),&t2,&t1);
+	BIG_dsub(E0,E0,A0);
+	BIG_dsub(E0,E0,B0);
+	BIG_dsub(E1,E1,A1);
+	BIG_dsub(E1,E1,B1);
+	FP2_dmod(&(w->b),E0,E1,3);	/* wb = (xa+xb)(ya+yb) - xa.ya - xb.yb */
 
-    FP4_norm(w);
+	BIG_dsub(T,B0,B1);			/* (1+i)(B0+iB1) = (B0-B1)+i(B0+B1) */
+	BIG_dadd(B1,B0,B1);
+	BIG_dadd(A0,A0,T);
+	BIG_dadd(A1,A1,B1);
+	FP2_dmod(&(w->a),A0,A1,3);	/* wa = xa.ya + (1+i).xb.yb */
 }
 
 /* output FP4 in format [a,b] */
@@ -295,6 +296,40 @@ void YYY::FP4_inv(FP4 *w,FP4 *x)
     FP2_mul(&(w->b),&t1,&(x->b));
 }
 
+/* Set w[i]=1/x[i] for i=0 to n-1, using just one inversion */
+/* Zeros are skipped and map to 0 */
+void YYY::FP4_inv_batch(FP4 *w,FP4 *x,int n)
+{
+	int i,z;
+	FP4 acc,t,one,zero;
+	if (n<=0) return;
+	FP4_one(&one);
+	FP4_zero(&zero);
+
+	FP4_copy(&acc,&one);
+	for (i=0;i<n;i++)
+	{
+		FP4_copy(&w[i],&acc);
+		FP4_copy(&t,&x[i]);
+		FP4_norm(&t);
+		FP4_cmove(&t,&one,FP4_iszilch(&t));
+		FP4_mul(&acc,&acc,&t);
+	}
+
+	FP4_inv(&acc,&acc);
+
+	for (i=n-1;i>=0;i--)
+	{
+		FP4_copy(&t,&x[i]);
+		FP4_norm(&t);
+		z=FP4_iszilch(&t);
+		FP4_cmove(&t,&one,z);
+		FP4_mul(&w[i],&w[i],&acc);
+		FP4_mul(&acc,&acc,&t);
+		FP4_cmove(&w[i],&zero,z);
+	}
+}
+
 /* w*=i where i = sqrt(-1+sqrt(-1)) */
 /* SU= 200 */
 void YYY::FP4_times_i(FP4 *w)
@@ -162,6 +162,14 @@ extern void FP4_mul(FP4 *x,FP4 *y,FP4 *z);
 	@param y FP4 instance
  */
 extern void FP4_inv(FP4 *x,FP4 *y);
+/**	@brief Simultaneous inversion of n FP4s
+ *
+	Uses Montgomery's trick - one inversion plus 3(n-1) multiplications. Zero elements are mapped to zero
+	@param x array of n FP4s, on exit x[i] = 1/y[i]. Must be distinct from y
+	@param y array of n FP4s
+	@param n number of elements
+ */
+extern void FP4_inv_batch(FP4 *x,FP4 *y,int n);
 
 /**	@brief Divide an FP4 by 2
  *
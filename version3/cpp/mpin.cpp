@@ -443,13 +443,13 @@ int ZZZ::MPIN_CLIENT_1(int sha,int date,octet *CLIENT_ID,csprng *RNG,octet *X,in
             {
                 PAIR_G1mul(&P,x);				// P=x.H(ID)
                 ECP_toOctet(xID,&P,false);  // xID		/* change to TRUE for point compression */
-                PAIR_G1mul(&W,x);               // W=x.H(T|ID)
+                PAIR_G1mul_proj(&W,x);          // W=x.H(T|ID)
                 ECP_add(&P,&W); 
             }
             else
             {
                 ECP_add(&P,&W); //ECP_affine(&P);
-                PAIR_G1mul(&P,x);
+                PAIR_G1mul_proj(&P,x);
             }
             if (xCID!=NULL) ECP_toOctet(xCID,&P,false);  // U     /* change to TRUE for point compression */
         }
@@ -593,7 +593,7 @@ int ZZZ::MPIN_SERVER_2(int date,octet *HID,octet *HTID,octet *Y,octet *SST,octet
     }
     if (res==0)
     {
-        PAIR_G1mul(&P,y);  // y(A+AT)
+        PAIR_G1mul_proj(&P,y);  // y(A+AT)
         ECP_add(&P,&R); // x(A+AT)+y(A+T)
         if (!ECP_fromOctet(&R,mSEC))  res=MPIN_INVALID_POINT; // V
     }
@@ -619,7 +619,7 @@ int ZZZ::MPIN_SERVER_2(int date,octet *HID,octet *HTID,octet *Y,octet *SST,octet
 
                     if (res==0)
                     {
-                        PAIR_G1mul(&P,y);  // yA
+                        PAIR_G1mul_proj(&P,y);  // yA
                         ECP_add(&P,&R); // yA+xA
                     }
                 }
@@ -826,7 +826,7 @@ int ZZZ::MPIN_SERVER_KEY(int sha,octet *Z,octet *SST,octet *W,octet *H,octet *HI
 
     if (res==0)
     {
-        PAIR_G1mul(&A,h);
+        PAIR_G1mul_proj(&A,h);
         ECP_add(&R,&A);  // new
         PAIR_ate(&g,&sQ,&R);
         PAIR_fexp(&g);
@@ -27,17 +27,25 @@ using namespace XXX;
 using namespace YYY;
 
 namespace ZZZ {
+	static void PAIR_lcoeffs(FP2 L[3],ECP2 *,ECP2 *);
+	static void PAIR_lform(FP12 *,FP2 L[3]);
+	static void PAIR_leval(FP12 *,FP2 L[3],FP *,FP *);
+	static void PAIR_lscale(FP2 L[][3],ECP **,int);
 	static void PAIR_line(FP12 *,ECP2 *,ECP2 *,FP *,FP *);
+	static int PAIR_nlines();
+	static void PAIR_multi_loop(FP12 *,PAIR_precomp *,ECP *,ECP2 *,ECP *,int,FP2 L[][3],ECP **,ECP2 *,ECP2 *,ECP *);
+	NOINLINE static void PAIR_multi_small(FP12 *,PAIR_precomp *,ECP *,ECP2 *,ECP *,int);
+	NOINLINE static void PAIR_multi_large(FP12 *,PAIR_precomp *,ECP *,ECP2 *,ECP *,int);
 	static void glv(BIG u[2],BIG);
 	static void gs(BIG u[4],BIG);
 }
 
-/* Line function */
-static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
+/* Line function coefficients. The line through A and B, or the tangent at A if A==B, is L[0]+L[1].Qy+L[2].Qx at Q=(Qx,Qy) */
+/* A is updated to A+B, or 2A */
+static void ZZZ::PAIR_lcoeffs(FP2 L[3],ECP2 *A,ECP2 *B)
 {
 	FP2 X1,Y1,T1,T2;
 	FP2 XX,YY,ZZ,YZ;
-    FP4 a,b,c;
 
 	if (A==B)
     {
@@ -58,12 +66,9 @@ static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
 		FP2_norm(&YZ);			//YZ.norm();       //-4YZ
 
 		FP2_imul(&XX,&XX,6);				//6X^2
-		FP2_pmul(&XX,&XX,Qx);	            //6X^2.Xs
 
 		FP2_imul(&ZZ,&ZZ,3*CURVE_B_I);	//3Bz^2 
 
-		FP2_pmul(&YZ,&YZ,Qy);	//-4YZ.Ys
-
 #if SEXTIC_TWIST_ZZZ==D_TYPE
 		FP2_div_ip2(&ZZ);		//6(b/i)z^2
 #endif
@@ -79,15 +84,9 @@ static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
 		FP2_sub(&ZZ,&ZZ,&YY);	// 
 		FP2_norm(&ZZ);			// 6b.Z^2-2Y^2
 
-		FP4_from_FP2s(&a,&YZ,&ZZ); // -4YZ.Ys | 6b.Z^2-2Y^2 | 6X^2.Xs 
-#if SEXTIC_TWIST_ZZZ==D_TYPE
-		FP4_from_FP2(&b,&XX);	
-		FP4_zero(&c);
-#endif
-#if SEXTIC_TWIST_ZZZ==M_TYPE
-		FP4_zero(&b);
-		FP4_from_FP2H(&c,&XX);
-#endif
+		FP2_copy(&L[0],&ZZ);	// 6b.Z^2-2Y^2
+		FP2_copy(&L[1],&YZ);	// -4YZ
+		FP2_copy(&L[2],&XX);	// 6X^2
 
 		ECP2_dbl(A);				//A.dbl();
     }
@@ -111,7 +110,6 @@ static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
 
 		FP2_copy(&T1,&X1);			//T1.copy(X1);            // T1=X1-Z1.X2
 
-		FP2_pmul(&X1,&X1,Qy);		//X1.pmul(Qy);            // X1=(X1-Z1.X2).Ys
 #if SEXTIC_TWIST_ZZZ==M_TYPE
 		FP2_mul_ip(&X1);
 		FP2_norm(&X1);
@@ -123,26 +121,85 @@ static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
 		FP2_mul(&T2,&T2,&(B->x));	//T2.mul(B.getx());       // T2=(Y1-Z1.Y2).X2
 		FP2_sub(&T2,&T2,&T1);		//T2.sub(T1); 
 		FP2_norm(&T2);				//T2.norm();          // T2=(Y1-Z1.Y2).X2 - (X1-Z1.X2).Y2
-		FP2_pmul(&Y1,&Y1,Qx);		//Y1.pmul(Qx);  
 		FP2_neg(&Y1,&Y1);			//Y1.neg(); 
-		FP2_norm(&Y1);				//Y1.norm(); // Y1=-(Y1-Z1.Y2).Xs
+		FP2_norm(&Y1);				//Y1.norm(); // Y1=-(Y1-Z1.Y2)
+
+		FP2_copy(&L[0],&T2);		// (Y1-Z1.Y2).X2 - (X1-Z1.X2).Y2
+		FP2_copy(&L[1],&X1);		// X1-Z1.X2
+		FP2_copy(&L[2],&Y1);		// -(Y1-Z1.Y2)
+
+		ECP2_add(A,B);				//A.add(B);
+    }
+}
+
+/* Evaluate line with coefficients L at Q=(Qx,Qy) */
+static void ZZZ::PAIR_leval(FP12 *v,FP2 L[3],FP *Qx,FP *Qy)
+{
+	FP2 S[3];
 
-		FP4_from_FP2s(&a,&X1,&T2);	// (X1-Z1.X2).Ys  |  (Y1-Z1.Y2).X2 - (X1-Z1.X2).Y2  | - (Y1-Z1.Y2).Xs
+	FP2_copy(&S[0],&L[0]);
+	FP2_pmul(&S[1],&L[1],Qy);
+	FP2_pmul(&S[2],&L[2],Qx);
+	PAIR_lform(v,S);
+}
+
+/* Sparse line value from coefficients L already scaled by Qy and Qx */
+static void ZZZ::PAIR_lform(FP12 *v,FP2 L[3])
+{
+    FP4 a,b,c;
+
+	FP4_from_FP2s(&a,&L[1],&L[0]);
 #if SEXTIC_TWIST_ZZZ==D_TYPE
-		FP4_from_FP2(&b,&Y1);		//b=new FP4(Y1);
-		FP4_zero(&c);
+	FP4_from_FP2(&b,&L[2]);
+	FP4_zero(&c);
 #endif
 #if SEXTIC_TWIST_ZZZ==M_TYPE
-		FP4_zero(&b);
-		FP4_from_FP2H(&c,&Y1);		//b=new FP4(Y1);
+	FP4_zero(&b);
+	FP4_from_FP2H(&c,&L[2]);
 #endif
-		ECP2_add(A,B);				//A.add(B);
-    }
 
     FP12_from_FP4s(v,&a,&b,&c);
 	v->type=FP_SPARSER;
 }
 
+/* Scale L[j][1] by Q[j].y and L[j][2] by Q[j].x for j=0 to n-1, for PAIR_lform */
+/* Four FP products per line, so FP_mul_x8 does two lines at a time */
+static void ZZZ::PAIR_lscale(FP2 L[][3],ECP **Q,int n)
+{
+	int i,j,k;
+	FP a[8],b[8],c[8];
+	FP *w[8];
+
+	k=0;
+	for (j=0; j<n; j++)
+	{
+		w[k]=&(L[j][1].a); FP_copy(&a[k],w[k]); FP_copy(&b[k++],&(Q[j]->y));
+		w[k]=&(L[j][1].b); FP_copy(&a[k],w[k]); FP_copy(&b[k++],&(Q[j]->y));
+		w[k]=&(L[j][2].a); FP_copy(&a[k],w[k]); FP_copy(&b[k++],&(Q[j]->x));
+		w[k]=&(L[j][2].b); FP_copy(&a[k],w[k]); FP_copy(&b[k++],&(Q[j]->x));
+		if (k==8 || j==n-1)
+		{
+			for (i=k; i<8; i++)
+			{
+				FP_zero(&a[i]);
+				FP_zero(&b[i]);
+			}
+			FP_mul_x8(c,a,b);
+			for (i=0; i<k; i++)
+				FP_copy(w[i],&c[i]);
+			k=0;
+		}
+	}
+}
+
+/* Line function */
+static void ZZZ::PAIR_line(FP12 *v,ECP2 *A,ECP2 *B,FP *Qx,FP *Qy)
+{
+	FP2 L[3];
+	PAIR_lcoeffs(L,A,B);
+	PAIR_leval(v,L,Qx,Qy);
+}
+
 /* prepare ate parameter, n=6u+2 (BN) or n=u (BLS), n3=3*n */
 int ZZZ::PAIR_nbits(BIG n3,BIG n)
 {
@@ -170,6 +227,7 @@ int ZZZ::PAIR_nbits(BIG n3,BIG n)
 
 /*
 	For multi-pairing, product of n pairings
+	(PAIR_ate_multi() does the same in one call, without the large array)
 	1. Declare FP12 array of length number of bits in Ate parameter
 	2. Initialise this array by calling PAIR_initmp()
 	3. Accumulate each pairing by calling PAIR_another() n times
@@ -466,6 +524,388 @@ void ZZZ::PAIR_double_ate(FP12 *r,ECP2 *P1,ECP *Q1,ECP2 *R1,ECP *S1)
 #endif
 }
 
+/* Number of lines in the Miller loop */
+static int ZZZ::PAIR_nlines()
+{
+	int i,nb,k;
+	BIG n,n3;
+	nb=PAIR_nbits(n3,n);
+	k=0;
+	for (i=nb-2; i>=1; i--)
+	{
+		k++;
+		if (BIG_bit(n3,i)!=BIG_bit(n,i)) k++;
+	}
+#if PAIRING_FRIENDLY_ZZZ==BN
+	k+=2;
+#endif
+	return k;
+}
+
+/* Precompute the lines of the Miller loop for a fixed P, in the order in which they are used */
+void ZZZ::PAIR_precomp_init(PAIR_precomp *T,ECP2 *PV)
+{
+	int i,j,k,nb,bt;
+	BIG n,n3;
+	ECP2 A,NP,P;
+#if PAIRING_FRIENDLY_ZZZ==BN
+	ECP2 K;
+    FP2 X;
+	FP Qx,Qy;
+    FP_rcopy(&Qx,Fra);
+    FP_rcopy(&Qy,Frb);
+    FP2_from_FPs(&X,&Qx,&Qy);
+#if SEXTIC_TWIST_ZZZ==M_TYPE
+	FP2_inv(&X,&X);
+	FP2_norm(&X);
+#endif
+#endif
+
+	nb=PAIR_nbits(n3,n);
+
+	ECP2_copy(&P,PV);
+	ECP2_affine(&P);
+
+	ECP2_copy(&A,&P);
+	ECP2_copy(&NP,&P); ECP2_neg(&NP);
+
+	k=0;
+	for (i=nb-2; i>=1; i--)
+	{
+		PAIR_lcoeffs(T->L[k++],&A,&A);
+
+		bt=BIG_bit(n3,i)-BIG_bit(n,i);
+		if (bt==1)
+			PAIR_lcoeffs(T->L[k++],&A,&P);
+		if (bt==-1)
+			PAIR_lcoeffs(T->L[k++],&A,&NP);
+	}
+
+#if PAIRING_FRIENDLY_ZZZ==BN
+
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+	ECP2_neg(&A);
+#endif
+
+	ECP2_copy(&K,&P);
+	ECP2_frob(&K,&X);
+	PAIR_lcoeffs(T->L[k++],&A,&K);
+	ECP2_frob(&K,&X);
+	ECP2_neg(&K);
+	PAIR_lcoeffs(T->L[k++],&A,&K);
+
+#endif
+
+	for (i=0; i<k; i++)
+		for (j=0; j<3; j++)
+			FP2_reduce(&(T->L[i][j]));
+	T->n=k;
+}
+
+/* Output table to octet string, as the coefficients of its lines */
+void ZZZ::PAIR_precomp_toOctet(octet *S,PAIR_precomp *T)
+{
+	int i,j;
+	BIG b;
+	S->len=0;
+	for (i=0; i<T->n; i++)
+		for (j=0; j<3; j++)
+		{
+			FP_redc(b,&(T->L[i][j].a));
+			BIG_toBytes(&(S->val[S->len]),b);
+			S->len+=MODBYTES_XXX;
+			FP_redc(b,&(T->L[i][j].b));
+			BIG_toBytes(&(S->val[S->len]),b);
+			S->len+=MODBYTES_XXX;
+		}
+}
+
+/* Restore table from octet string. Returns 0 if the length is wrong. The lines cannot be checked, so S must come from a trusted source */
+int ZZZ::PAIR_precomp_fromOctet(PAIR_precomp *T,octet *S)
+{
+	int i,j,k;
+	BIG a,b;
+	k=PAIR_nlines();
+	if (S->len!=6*MODBYTES_XXX*k) return 0;
+	for (i=0; i<k; i++)
+		for (j=0; j<3; j++)
+		{
+			BIG_fromBytes(a,&(S->val[(6*i+2*j)*MODBYTES_XXX]));
+			BIG_fromBytes(b,&(S->val[(6*i+2*j+1)*MODBYTES_XXX]));
+			FP2_from_BIGs(&(T->L[i][j]),a,b);
+		}
+	T->n=k;
+	return 1;
+}
+
+/* Accumulate the line functions of precomputed P at Q for n-pairing. Only the cheap line evaluations are needed */
+void ZZZ::PAIR_another_precomp(FP12 r[],PAIR_precomp *T,ECP* QV)
+{
+	int i,k,nb;
+	BIG n,n3;
+	FP12 lv,lv2;
+	ECP Q;
+	FP Qx,Qy;
+
+	nb=PAIR_nbits(n3,n);
+
+	ECP_copy(&Q,QV);
+	ECP_affine(&Q);
+
+	FP_copy(&Qx,&(Q.x));
+	FP_copy(&Qy,&(Q.y));
+
+	k=0;
+	for (i=nb-2; i>=1; i--)
+	{
+		PAIR_leval(&lv,T->L[k++],&Qx,&Qy);
+		if (BIG_bit(n3,i)!=BIG_bit(n,i))
+		{
+			PAIR_leval(&lv2,T->L[k++],&Qx,&Qy);
+			FP12_smul(&lv,&lv2);
+		}
+		FP12_ssmul(&r[i],&lv);
+	}
+
+#if PAIRING_FRIENDLY_ZZZ==BN
+	PAIR_leval(&lv,T->L[k++],&Qx,&Qy);
+	PAIR_leval(&lv2,T->L[k++],&Qx,&Qy);
+	FP12_smul(&lv,&lv2);
+	FP12_ssmul(&r[0],&lv);
+#endif
+}
+
+/* Optimal R-ate pairing r=e(P,Q), for precomputed P */
+void ZZZ::PAIR_ate_precomp(FP12 *r,PAIR_precomp *T,ECP *Q1)
+{
+	int i,k,nb;
+	BIG n,n3;
+	FP12 lv,lv2;
+	ECP Q;
+	FP Qx,Qy;
+
+	nb=PAIR_nbits(n3,n);
+
+	ECP_copy(&Q,Q1);
+	ECP_affine(&Q);
+
+	FP_copy(&Qx,&(Q.x));
+	FP_copy(&Qy,&(Q.y));
+
+	FP12_one(r);
+
+	/* Main Miller Loop */
+	k=0;
+	for (i=nb-2; i>=1; i--)
+	{
+		FP12_sqr(r,r);
+		PAIR_leval(&lv,T->L[k++],&Qx,&Qy);
+		if (BIG_bit(n3,i)!=BIG_bit(n,i))
+		{
+			PAIR_leval(&lv2,T->L[k++],&Qx,&Qy);
+			FP12_smul(&lv,&lv2);
+		}
+		FP12_ssmul(r,&lv);
+	}
+
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+	FP12_conj(r,r);
+#endif
+
+	/* R-ate fixup required for BN curves */
+#if PAIRING_FRIENDLY_ZZZ==BN
+	PAIR_leval(&lv,T->L[k++],&Qx,&Qy);
+	PAIR_leval(&lv2,T->L[k++],&Qx,&Qy);
+	FP12_smul(&lv,&lv2);
+	FP12_ssmul(r,&lv);
+#endif
+}
+
+#define PAIR_MULTI_SMALL 2 /* up to this many pairings use the smaller working memory of PAIR_multi_small */
+
+/* Shared Miller loop for e(P[0],Q[0])...e(P[m-1],Q[m-1]), times e(T,S) if T is not NULL */
+/* The accumulator is squared once per bit, and each pair multiplies in its sparse lines */
+/* The caller provides the working memory, 2m+2 lines L and their points Z, and m points A, P and Q */
+static void ZZZ::PAIR_multi_loop(FP12 *r,PAIR_precomp *T,ECP *S,ECP2 *PV,ECP *QV,int m,FP2 L[][3],ECP **Z,ECP2 *A,ECP2 *P,ECP *Q)
+{
+	int i,j,k,c,nb,bt;
+	BIG n,n3;
+	FP12 lv,lv2;
+	ECP2 NP;
+	ECP SA;
+#if PAIRING_FRIENDLY_ZZZ==BN
+	ECP2 K;
+	FP2 X;
+	FP Fx,Fy;
+
+	FP_rcopy(&Fx,Fra);
+	FP_rcopy(&Fy,Frb);
+	FP2_from_FPs(&X,&Fx,&Fy);
+
+#if SEXTIC_TWIST_ZZZ==M_TYPE
+	FP2_inv(&X,&X);
+	FP2_norm(&X);
+#endif
+
+#endif
+
+	nb=PAIR_nbits(n3,n);
+
+	for (j=0; j<m; j++)
+	{
+		ECP2_copy(&P[j],&PV[j]);
+		ECP_copy(&Q[j],&QV[j]);
+	}
+	ECP2_affine_batch(P,m);
+	ECP_affine_batch(Q,m);
+	for (j=0; j<m; j++)
+		ECP2_copy(&A[j],&P[j]);
+
+	if (T!=NULL)
+	{
+		ECP_copy(&SA,S);
+		ECP_affine(&SA);
+	}
+
+	FP12_one(r);
+
+	/* Main Miller Loop */
+	/* All the lines of one step are scaled together, then multiplied in one or two at a time */
+	k=0;
+	for (i=nb-2; i>=1; i--)
+	{
+		FP12_sqr(r,r);
+
+		bt=BIG_bit(n3,i)-BIG_bit(n,i);
+		c=0;
+		if (T!=NULL)
+		{
+			FP2_copy(&L[c][0],&(T->L[k][0])); FP2_copy(&L[c][1],&(T->L[k][1])); FP2_copy(&L[c][2],&(T->L[k][2]));
+			Z[c++]=&SA; k++;
+			if (bt!=0)
+			{
+				FP2_copy(&L[c][0],&(T->L[k][0])); FP2_copy(&L[c][1],&(T->L[k][1])); FP2_copy(&L[c][2],&(T->L[k][2]));
+				Z[c++]=&SA; k++;
+			}
+		}
+		for (j=0; j<m; j++)
+		{
+			PAIR_lcoeffs(L[c],&A[j],&A[j]);
+			Z[c++]=&Q[j];
+			if (bt==1)
+			{
+				PAIR_lcoeffs(L[c],&A[j],&P[j]);
+				Z[c++]=&Q[j];
+			}
+			if (bt==-1)
+			{
+				ECP2_copy(&NP,&P[j]); ECP2_neg(&NP);
+				PAIR_lcoeffs(L[c],&A[j],&NP);
+				Z[c++]=&Q[j];
+			}
+		}
+		PAIR_lscale(L,Z,c);
+		for (j=0; j<c; j++)
+		{
+			PAIR_lform(&lv,L[j]);
+			if (bt!=0)
+			{
+				PAIR_lform(&lv2,L[++j]);
+				FP12_smul(&lv,&lv2);
+			}
+			FP12_ssmul(r,&lv);
+		}
+	}
+
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+	FP12_conj(r,r);
+#endif
+
+	/* R-ate fixup required for BN curves */
+#if PAIRING_FRIENDLY_ZZZ==BN
+	c=0;
+	if (T!=NULL)
+	{
+		for (j=0; j<2; j++)
+		{
+			FP2_copy(&L[c][0],&(T->L[k][0])); FP2_copy(&L[c][1],&(T->L[k][1])); FP2_copy(&L[c][2],&(T->L[k][2]));
+			Z[c++]=&SA; k++;
+		}
+	}
+	for (j=0; j<m; j++)
+	{
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+		ECP2_neg(&A[j]);
+#endif
+		ECP2_copy(&K,&P[j]);
+		ECP2_frob(&K,&X);
+		PAIR_lcoeffs(L[c],&A[j],&K);
+		Z[c++]=&Q[j];
+		ECP2_frob(&K,&X);
+		ECP2_neg(&K);
+		PAIR_lcoeffs(L[c],&A[j],&K);
+		Z[c++]=&Q[j];
+	}
+	PAIR_lscale(L,Z,c);
+	for (j=0; j<c; j+=2)
+	{
+		PAIR_lform(&lv,L[j]);
+		PAIR_lform(&lv2,L[j+1]);
+		FP12_smul(&lv,&lv2);
+		FP12_ssmul(r,&lv);
+	}
+#endif
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_SMALL, such as the two pairings of a signature check */
+NOINLINE
+static void ZZZ::PAIR_multi_small(FP12 *r,PAIR_precomp *T,ECP *S,ECP2 *PV,ECP *QV,int m)
+{
+	FP2 L[2*PAIR_MULTI_SMALL+2][3];
+	ECP *Z[2*PAIR_MULTI_SMALL+2];
+	ECP2 A[PAIR_MULTI_SMALL],P[PAIR_MULTI_SMALL];
+	ECP Q[PAIR_MULTI_SMALL];
+	PAIR_multi_loop(r,T,S,PV,QV,m,L,Z,A,P,Q);
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_MAX */
+NOINLINE
+static void ZZZ::PAIR_multi_large(FP12 *r,PAIR_precomp *T,ECP *S,ECP2 *PV,ECP *QV,int m)
+{
+	FP2 L[2*PAIR_MULTI_MAX_ZZZ+2][3];
+	ECP *Z[2*PAIR_MULTI_MAX_ZZZ+2];
+	ECP2 A[PAIR_MULTI_MAX_ZZZ],P[PAIR_MULTI_MAX_ZZZ];
+	ECP Q[PAIR_MULTI_MAX_ZZZ];
+	PAIR_multi_loop(r,T,S,PV,QV,m,L,Z,A,P,Q);
+}
+
+/* Optimal R-ate n-pairing r=e(P[0],Q[0])...e(P[n-1],Q[n-1]) */
+void ZZZ::PAIR_ate_multi(FP12 *r,ECP2 *P,ECP *Q,int n)
+{
+	PAIR_ate_multi_precomp(r,NULL,NULL,P,Q,n);
+}
+
+/* Optimal R-ate n-pairing r=e(T,S).e(P[0],Q[0])...e(P[n-1],Q[n-1]), for precomputed T */
+/* Pairs are taken PAIR_MULTI_MAX at a time, so the working memory does not depend on n. Up to PAIR_MULTI_SMALL pairs need less */
+void ZZZ::PAIR_ate_multi_precomp(FP12 *r,PAIR_precomp *T,ECP *S,ECP2 *P,ECP *Q,int n)
+{
+	int j,m;
+	FP12 t;
+
+	m=n;
+	if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+	if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(r,T,S,P,Q,m);
+	else PAIR_multi_large(r,T,S,P,Q,m);
+	for (j=m; j<n; j+=m)
+	{
+		m=n-j;
+		if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+		if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(&t,NULL,NULL,&P[j],&Q[j],m);
+		else PAIR_multi_large(&t,NULL,NULL,&P[j],&Q[j],m);
+		FP12_mul(r,&t);
+	}
+}
+
 /* final exponentiation - keep separate for multi-pairings and to avoid thrashing stack */
 void ZZZ::PAIR_fexp(FP12 *r)
 {
@@ -498,7 +938,7 @@ void ZZZ::PAIR_fexp(FP12 *r)
 	}
     /* Hard part of final exp - see Duquesne & Ghamman eprint 2015/192.pdf */
 #if PAIRING_FRIENDLY_ZZZ==BN
-    FP12_pow(&t0,r,x); // t0=f^-u
+    FP12_upow(&t0,r,x); // t0=f^-u
 #if SIGN_OF_X_ZZZ==POSITIVEX
 	FP12_conj(&t0,&t0);
 #endif
@@ -511,7 +951,7 @@ void ZZZ::PAIR_fexp(FP12 *r)
     FP12_usqr(&y2,&y2); //y2=y2^2
     FP12_mul(&y2,&y3); // y2=y2*y3
 
-    FP12_pow(&t0,&y0,x);  //t0=y0^-u
+    FP12_upow(&t0,&y0,x);  //t0=y0^-u
 #if SIGN_OF_X_ZZZ==POSITIVEX
 	FP12_conj(&t0,&t0);
 #endif
@@ -527,7 +967,7 @@ void ZZZ::PAIR_fexp(FP12 *r)
     FP12_usqr(&t0,&t0); // t0=t0^2
     FP12_mul(&y1,&t0); // y1=t0*y1
 
-    FP12_pow(&t0,&y3,x); // t0=y3^-u
+    FP12_upow(&t0,&y3,x); // t0=y3^-u
 #if SIGN_OF_X_ZZZ==POSITIVEX
 	FP12_conj(&t0,&t0);
 #endif
@@ -554,13 +994,13 @@ void ZZZ::PAIR_fexp(FP12 *r)
 // Ghamman & Fouotsa Method
 
     FP12_usqr(&y0,r);
-    FP12_pow(&y1,&y0,x);
+    FP12_upow(&y1,&y0,x);
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP12_conj(&y1,&y1);
 #endif
 
     BIG_fshr(x,1);
-    FP12_pow(&y2,&y1,x);
+    FP12_upow(&y2,&y1,x);
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP12_conj(&y2,&y2);
 #endif
@@ -571,11 +1011,11 @@ void ZZZ::PAIR_fexp(FP12 *r)
     FP12_conj(&y1,&y1);
     FP12_mul(&y1,&y2);
 
-    FP12_pow(&y2,&y1,x);
+    FP12_upow(&y2,&y1,x);
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP12_conj(&y2,&y2);
 #endif
-    FP12_pow(&y3,&y2,x);
+    FP12_upow(&y3,&y2,x);
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP12_conj(&y3,&y3);
 #endif
@@ -590,7 +1030,7 @@ void ZZZ::PAIR_fexp(FP12 *r)
     FP12_frob(&y2,&X);
     FP12_mul(&y1,&y2);
 
-    FP12_pow(&y2,&y3,x);
+    FP12_upow(&y2,&y3,x);
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP12_conj(&y2,&y2);
 #endif
@@ -707,8 +1147,8 @@ static void ZZZ::gs(BIG u[4],BIG e)
     return;
 }
 
-/* Multiply P by e in group G1 */
-void ZZZ::PAIR_G1mul(ECP *P,BIG e)
+/* Multiply P by e in group G1, leaving P in projective coordinates */
+void ZZZ::PAIR_G1mul_proj(ECP *P,BIG e)
 {
 #ifdef USE_GLV_ZZZ   /* Note this method is patented */
     int np,nn;
@@ -720,7 +1160,7 @@ void ZZZ::PAIR_G1mul(ECP *P,BIG e)
     BIG_rcopy(q,CURVE_Order);
     glv(u,e);
 
-    ECP_copy(&Q,P); ECP_affine(&Q);
+    ECP_copy(&Q,P);
     FP_rcopy(&cru,CURVE_Cru);
     FP_mul(&(Q.x),&(Q.x),&cru);
 
@@ -745,15 +1185,22 @@ void ZZZ::PAIR_G1mul(ECP *P,BIG e)
     }
     BIG_norm(u[0]);
     BIG_norm(u[1]);
-    ECP_mul2(P,&Q,u[0],u[1]);
+    ECP_mul2_proj(P,&Q,u[0],u[1]);
 
 #else
-    ECP_mul(P,e);
+    ECP_mul_proj(P,e);
 #endif
 }
 
-/* Multiply P by e in group G2 */
-void ZZZ::PAIR_G2mul(ECP2 *P,BIG e)
+/* Multiply P by e in group G1 */
+void ZZZ::PAIR_G1mul(ECP *P,BIG e)
+{
+    PAIR_G1mul_proj(P,e);
+    ECP_affine(P);
+}
+
+/* Multiply P by e in group G2, leaving P in projective coordinates */
+void ZZZ::PAIR_G2mul_proj(ECP2 *P,BIG e)
 {
 #ifdef USE_GS_G2_ZZZ   /* Well I didn't patent it :) */
     int i,np,nn;
@@ -796,13 +1243,20 @@ void ZZZ::PAIR_G2mul(ECP2 *P,BIG e)
         BIG_norm(u[i]);  
     }
 
-    ECP2_mul4(P,Q,u);
+    ECP2_mul4_proj(P,Q,u);
 
 #else
-    ECP2_mul(P,e);
+    ECP2_mul_proj(P,e);
 #endif
 }
 
+/* Multiply P by e in group G2 */
+void ZZZ::PAIR_G2mul(ECP2 *P,BIG e)
+{
+    PAIR_G2mul_proj(P,e);
+    ECP2_affine(P);
+}
+
 /* f=f^e */
 void ZZZ::PAIR_GTpow(FP12 *f,BIG e)
 {
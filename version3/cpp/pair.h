@@ -18,6 +18,19 @@ extern const XXX::BIG CURVE_SB[2][2]; /**< BN curve constant for GLV decompositi
 extern const XXX::BIG CURVE_WB[4];	 /**< BN curve constant for GS decomposition */
 extern const XXX::BIG CURVE_BB[4][4]; /**< BN curve constant for GS decomposition */
 
+#define PAIR_PRECOMP_LINES_ZZZ (ATE_BITS_ZZZ+(ATE_BITS_ZZZ+1)/2+2) /**< Bound on the number of lines in the Miller loop */
+#define PAIR_MULTI_MAX_ZZZ 16 /**< Number of pairings that share one pass of the Miller loop in PAIR_ate_multi */
+
+/**
+	@brief PAIR_precomp structure - line functions of a fixed G2 point, for pairings with varying G1 points
+*/
+
+typedef struct
+{
+    int n; /**< Number of lines */
+    YYY::FP2 L[PAIR_PRECOMP_LINES_ZZZ][3]; /**< Coefficients of the lines of the Miller loop, in order. Line i at G1 point (x,y) is L[i][0]+L[i][1].y+L[i][2].x, in its sparse FP12 positions */
+} PAIR_precomp;
+
 /* Pairing function prototypes */
 
 /**	@brief Precompute line functions for n-pairing
@@ -48,6 +61,63 @@ extern void PAIR_ate(YYY::FP12 *r,ECP2 *P,ECP *Q);
 	@param S ECP instance, an element of G1
  */
 extern void PAIR_double_ate(YYY::FP12 *r,ECP2 *P,ECP *Q,ECP2 *R,ECP *S);
+/**	@brief Precompute the line functions of a fixed element of G2
+ *
+	For a fixed generator or a long-lived public key. Pairings with a precomputed P need only evaluate each line at Q, which removes the G2 arithmetic from the Miller loop
+	@param T PAIR_precomp instance, on exit the lines of P
+	@param P ECP2 instance, an element of G2
+ */
+extern void PAIR_precomp_init(PAIR_precomp *T,ECP2 *P);
+/**	@brief Output precomputed line functions to an octet string
+ *
+	@param S output octet string, of maximum length 6*MODBYTES*PAIR_PRECOMP_LINES
+	@param T PAIR_precomp instance
+ */
+extern void PAIR_precomp_toOctet(octet *S,PAIR_precomp *T);
+/**	@brief Restore precomputed line functions from an octet string
+ *
+	The lines cannot be validated, so S must come from a trusted source
+	@param T PAIR_precomp instance, on exit as serialised in S
+	@param S input octet string
+	@return 1 if OK, or 0 if S has the wrong length
+ */
+extern int PAIR_precomp_fromOctet(PAIR_precomp *T,octet *S);
+/**	@brief Precompute line functions for n-pairing, for precomputed P
+ *
+	As PAIR_another
+	@param r array of precomputed FP12 products of line functions
+	@param T PAIR_precomp instance, from an element P of G2
+	@param Q ECP instance, an element of G1
+ */
+extern void PAIR_another_precomp(YYY::FP12 r[],PAIR_precomp *T,ECP *Q);
+/**	@brief Calculate Miller loop for Optimal ATE pairing e(P,Q), for precomputed P
+ *
+	As PAIR_ate
+	@param r FP12 result of the pairing calculation e(P,Q)
+	@param T PAIR_precomp instance, from an element P of G2
+	@param Q ECP instance, an element of G1
+ */
+extern void PAIR_ate_precomp(YYY::FP12 *r,PAIR_precomp *T,ECP *Q);
+/**	@brief Calculate Miller loop for Optimal ATE n-pairing e(P[0],Q[0]).e(P[1],Q[1])...e(P[n-1],Q[n-1])
+ *
+	One Miller loop is shared by up to PAIR_MULTI_MAX pairings. Unlike PAIR_initmp/PAIR_another/PAIR_miller no FP12 array is needed
+	@param r FP12 result of the n-pairing calculation
+	@param P ECP2 array of n elements of G2
+	@param Q ECP array of n elements of G1
+	@param n number of pairings
+ */
+extern void PAIR_ate_multi(YYY::FP12 *r,ECP2 *P,ECP *Q,int n);
+/**	@brief Calculate Miller loop for Optimal ATE n-pairing e(T,S).e(P[0],Q[0])...e(P[n-1],Q[n-1]), for precomputed T
+ *
+	As PAIR_ate_multi, with one extra pairing whose G2 point has precomputed lines
+	@param r FP12 result of the n-pairing calculation
+	@param T PAIR_precomp instance, from an element of G2, or NULL for none
+	@param S ECP instance, an element of G1, paired with T
+	@param P ECP2 array of n elements of G2
+	@param Q ECP array of n elements of G1
+	@param n number of pairings
+ */
+extern void PAIR_ate_multi_precomp(YYY::FP12 *r,PAIR_precomp *T,ECP *S,ECP2 *P,ECP *Q,int n);
 /**	@brief Final exponentiation of pairing, converts output of Miller loop to element in GT
  *
 	Here p is the internal modulus, and r is the group order
@@ -62,6 +132,13 @@ extern void PAIR_fexp(YYY::FP12 *x);
 
  */
 extern void PAIR_G1mul(ECP *Q,XXX::BIG b);
+/**	@brief Fast point multiplication of a member of the group G1 by a BIG number, leaving the result in projective coordinates
+ *
+	As PAIR_G1mul, but saves the final inversion when the result is only used in further point arithmetic, pairings or is serialised.
+	@param Q ECP member of G1.
+	@param b BIG multiplier
+ */
+extern void PAIR_G1mul_proj(ECP *Q,XXX::BIG b);
 /**	@brief Fast point multiplication of a member of the group G2 by a BIG number
  *
 	May exploit endomorphism for speed.
@@ -70,6 +147,13 @@ extern void PAIR_G1mul(ECP *Q,XXX::BIG b);
 
  */
 extern void PAIR_G2mul(ECP2 *P,XXX::BIG b);
+/**	@brief Fast point multiplication of a member of the group G2 by a BIG number, leaving the result in projective coordinates
+ *
+	As PAIR_G2mul, but saves the final inversion when the result is only used in further point arithmetic, pairings or is serialised.
+	@param P ECP2 member of G2.
+	@param b BIG multiplier
+ */
+extern void PAIR_G2mul_proj(ECP2 *P,XXX::BIG b);
 /**	@brief Fast raising of a member of GT to a BIG power
  *
 	May exploit endomorphism for speed.
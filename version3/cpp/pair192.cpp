@@ -28,6 +28,9 @@ using namespace YYY;
 
 namespace ZZZ {
 	static void PAIR_line(FP24 *,ECP4 *,ECP4 *,FP *,FP *);
+	static void PAIR_multi_loop(FP24 *,ECP4 *,ECP *,int,ECP4 *,ECP4 *,ECP *);
+	NOINLINE static void PAIR_multi_small(FP24 *,ECP4 *,ECP *,int);
+	NOINLINE static void PAIR_multi_large(FP24 *,ECP4 *,ECP *,int);
 	static void glv(BIG u[2],BIG);
 	static void gs(BIG u[4],BIG);
 }
@@ -160,6 +163,7 @@ int ZZZ::PAIR_nbits(BIG n3,BIG n)
 
 /*
 	For multi-pairing, product of n pairings
+	(PAIR_ate_multi() does the same in one call, without the large array)
 	1. Declare FP24 array of length number of bits in Ate parameter
 	2. Initialise this array by calling PAIR_initmp()
 	3. Accumulate each pairing by calling PAIR_another() n times
@@ -362,6 +366,99 @@ void ZZZ::PAIR_double_ate(FP24 *r,ECP4 *P1,ECP *Q1,ECP4 *R1,ECP *S1)
 
 }
 
+#define PAIR_MULTI_SMALL 2 /* up to this many pairings use the smaller working memory of PAIR_multi_small */
+
+/* Shared Miller loop for e(P[0],Q[0])...e(P[m-1],Q[m-1]) */
+/* The accumulator is squared once per bit, and each pair multiplies in its sparse lines */
+/* The caller provides the working memory, m points A, P and Q */
+static void ZZZ::PAIR_multi_loop(FP24 *r,ECP4 *PV,ECP *QV,int m,ECP4 *A,ECP4 *P,ECP *Q)
+{
+	int i,j,nb,bt;
+	BIG n,n3;
+	FP24 lv,lv2;
+	ECP4 NP;
+
+	nb=PAIR_nbits(n3,n);
+
+	for (j=0; j<m; j++)
+	{
+		ECP4_copy(&P[j],&PV[j]);
+		ECP4_affine(&P[j]);
+		ECP4_copy(&A[j],&P[j]);
+		ECP_copy(&Q[j],&QV[j]);
+	}
+	ECP_affine_batch(Q,m);
+
+	FP24_one(r);
+
+	/* Main Miller Loop */
+	for (i=nb-2; i>=1; i--)
+	{
+		FP24_sqr(r,r);
+
+		bt=BIG_bit(n3,i)-BIG_bit(n,i);
+		for (j=0; j<m; j++)
+		{
+			PAIR_line(&lv,&A[j],&A[j],&(Q[j].x),&(Q[j].y));
+			if (bt==1)
+			{
+				PAIR_line(&lv2,&A[j],&P[j],&(Q[j].x),&(Q[j].y));
+				FP24_smul(&lv,&lv2);
+			}
+			if (bt==-1)
+			{
+				ECP4_copy(&NP,&P[j]); ECP4_neg(&NP);
+				PAIR_line(&lv2,&A[j],&NP,&(Q[j].x),&(Q[j].y));
+				FP24_smul(&lv,&lv2);
+			}
+			FP24_ssmul(r,&lv);
+		}
+	}
+
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+	FP24_conj(r,r);
+#endif
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_SMALL, such as the two pairings of a signature check */
+NOINLINE
+static void ZZZ::PAIR_multi_small(FP24 *r,ECP4 *PV,ECP *QV,int m)
+{
+	ECP4 A[PAIR_MULTI_SMALL],P[PAIR_MULTI_SMALL];
+	ECP Q[PAIR_MULTI_SMALL];
+	PAIR_multi_loop(r,PV,QV,m,A,P,Q);
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_MAX */
+NOINLINE
+static void ZZZ::PAIR_multi_large(FP24 *r,ECP4 *PV,ECP *QV,int m)
+{
+	ECP4 A[PAIR_MULTI_MAX_ZZZ],P[PAIR_MULTI_MAX_ZZZ];
+	ECP Q[PAIR_MULTI_MAX_ZZZ];
+	PAIR_multi_loop(r,PV,QV,m,A,P,Q);
+}
+
+/* Optimal R-ate n-pairing r=e(P[0],Q[0])...e(P[n-1],Q[n-1]) */
+/* Pairs are taken PAIR_MULTI_MAX at a time, so the working memory does not depend on n. Up to PAIR_MULTI_SMALL pairs need less */
+void ZZZ::PAIR_ate_multi(FP24 *r,ECP4 *P,ECP *Q,int n)
+{
+	int j,m;
+	FP24 t;
+
+	m=n;
+	if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+	if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(r,P,Q,m);
+	else PAIR_multi_large(r,P,Q,m);
+	for (j=m; j<n; j+=m)
+	{
+		m=n-j;
+		if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+		if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(&t,&P[j],&Q[j],m);
+		else PAIR_multi_large(&t,&P[j],&Q[j],m);
+		FP24_mul(r,&t);
+	}
+}
+
 /* final exponentiation - keep separate for multi-pairings and to avoid thrashing stack */
 
 void ZZZ::PAIR_fexp(FP24 *r)
@@ -396,10 +493,10 @@ void ZZZ::PAIR_fexp(FP24 *r)
 // Ghamman & Fouotsa Method - (completely garbled in  https://eprint.iacr.org/2016/130)
 
 	FP24_usqr(&t7,r);			// t7=f^2
-	FP24_pow(&t1,&t7,x);		// t1=t7^u
+	FP24_upow(&t1,&t7,x);		// t1=t7^u
 
 	BIG_fshr(x,1);
-	FP24_pow(&t2,&t1,x);		// t2=t1^(u/2)
+	FP24_upow(&t2,&t1,x);		// t2=t1^(u/2)
 	BIG_fshl(x,1);  // x must be even
 
 #if SIGN_OF_X_ZZZ==NEGATIVEX
@@ -411,9 +508,9 @@ void ZZZ::PAIR_fexp(FP24 *r)
 	FP24_mul(&t2,r);		// t2=t2*f
 
 
-	FP24_pow(&t3,&t2,x);		// t3=t2^u
-	FP24_pow(&t4,&t3,x);		// t4=t3^u
-	FP24_pow(&t5,&t4,x);		// t5=t4^u
+	FP24_upow(&t3,&t2,x);		// t3=t2^u
+	FP24_upow(&t4,&t3,x);		// t4=t3^u
+	FP24_upow(&t5,&t4,x);		// t5=t4^u
 
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP24_conj(&t3,&t3);
@@ -426,7 +523,7 @@ void ZZZ::PAIR_fexp(FP24 *r)
 	FP24_mul(&t3,&t4);		// t3=t3.t4
 
 
-	FP24_pow(&t6,&t5,x);		// t6=t5^u
+	FP24_upow(&t6,&t5,x);		// t6=t5^u
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP24_conj(&t6,&t6);
 #endif
@@ -443,8 +540,8 @@ void ZZZ::PAIR_fexp(FP24 *r)
 	FP24_frob(&t5,&X,3); 
 
 	FP24_mul(&t3,&t5);		// t3=t3*t5
-	FP24_pow(&t5,&t6,x);	// t5=t6^x
-	FP24_pow(&t6,&t5,x);	// t6=t5^x
+	FP24_upow(&t5,&t6,x);	// t5=t6^x
+	FP24_upow(&t6,&t5,x);	// t6=t5^x
 
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP24_conj(&t5,&t5);
@@ -457,7 +554,7 @@ void ZZZ::PAIR_fexp(FP24 *r)
 	FP24_frob(&t0,&X,1);
 
 	FP24_mul(&t3,&t0);		// t3=t3*t0
-	FP24_pow(&t5,&t6,x);    // t5=t6*x
+	FP24_upow(&t5,&t6,x);    // t5=t6*x
 
 #if SIGN_OF_X_ZZZ==NEGATIVEX
 	FP24_conj(&t5,&t5);
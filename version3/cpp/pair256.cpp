@@ -28,6 +28,9 @@ using namespace YYY;
 
 namespace ZZZ {
 	static void PAIR_line(FP48 *,ECP8 *,ECP8 *,FP *,FP *);
+	static void PAIR_multi_loop(FP48 *,ECP8 *,ECP *,int,ECP8 *,ECP8 *,ECP *);
+	NOINLINE static void PAIR_multi_small(FP48 *,ECP8 *,ECP *,int);
+	NOINLINE static void PAIR_multi_large(FP48 *,ECP8 *,ECP *,int);
 	static void glv(BIG u[2],BIG);
 	static void gs(BIG u[4],BIG);
 }
@@ -158,6 +161,7 @@ int ZZZ::PAIR_nbits(BIG n3,BIG n)
 
 /*
 	For multi-pairing, product of n pairings
+	(PAIR_ate_multi() does the same in one call, without the large array)
 	1. Declare FP24 array of length number of bits in Ate parameter
 	2. Initialise this array by calling PAIR_initmp()
 	3. Accumulate each pairing by calling PAIR_another() n times
@@ -358,6 +362,99 @@ void ZZZ::PAIR_double_ate(FP48 *r,ECP8 *P1,ECP *Q1,ECP8 *R1,ECP *S1)
 
 }
 
+#define PAIR_MULTI_SMALL 2 /* up to this many pairings use the smaller working memory of PAIR_multi_small */
+
+/* Shared Miller loop for e(P[0],Q[0])...e(P[m-1],Q[m-1]) */
+/* The accumulator is squared once per bit, and each pair multiplies in its sparse lines */
+/* The caller provides the working memory, m points A, P and Q */
+static void ZZZ::PAIR_multi_loop(FP48 *r,ECP8 *PV,ECP *QV,int m,ECP8 *A,ECP8 *P,ECP *Q)
+{
+	int i,j,nb,bt;
+	BIG n,n3;
+	FP48 lv,lv2;
+	ECP8 NP;
+
+	nb=PAIR_nbits(n3,n);
+
+	for (j=0; j<m; j++)
+	{
+		ECP8_copy(&P[j],&PV[j]);
+		ECP8_affine(&P[j]);
+		ECP8_copy(&A[j],&P[j]);
+		ECP_copy(&Q[j],&QV[j]);
+	}
+	ECP_affine_batch(Q,m);
+
+	FP48_one(r);
+
+	/* Main Miller Loop */
+	for (i=nb-2; i>=1; i--)
+	{
+		FP48_sqr(r,r);
+
+		bt=BIG_bit(n3,i)-BIG_bit(n,i);
+		for (j=0; j<m; j++)
+		{
+			PAIR_line(&lv,&A[j],&A[j],&(Q[j].x),&(Q[j].y));
+			if (bt==1)
+			{
+				PAIR_line(&lv2,&A[j],&P[j],&(Q[j].x),&(Q[j].y));
+				FP48_smul(&lv,&lv2);
+			}
+			if (bt==-1)
+			{
+				ECP8_copy(&NP,&P[j]); ECP8_neg(&NP);
+				PAIR_line(&lv2,&A[j],&NP,&(Q[j].x),&(Q[j].y));
+				FP48_smul(&lv,&lv2);
+			}
+			FP48_ssmul(r,&lv);
+		}
+	}
+
+#if SIGN_OF_X_ZZZ==NEGATIVEX
+	FP48_conj(r,r);
+#endif
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_SMALL, such as the two pairings of a signature check */
+NOINLINE
+static void ZZZ::PAIR_multi_small(FP48 *r,ECP8 *PV,ECP *QV,int m)
+{
+	ECP8 A[PAIR_MULTI_SMALL],P[PAIR_MULTI_SMALL];
+	ECP Q[PAIR_MULTI_SMALL];
+	PAIR_multi_loop(r,PV,QV,m,A,P,Q);
+}
+
+/* PAIR_multi_loop for m<=PAIR_MULTI_MAX */
+NOINLINE
+static void ZZZ::PAIR_multi_large(FP48 *r,ECP8 *PV,ECP *QV,int m)
+{
+	ECP8 A[PAIR_MULTI_MAX_ZZZ],P[PAIR_MULTI_MAX_ZZZ];
+	ECP Q[PAIR_MULTI_MAX_ZZZ];
+	PAIR_multi_loop(r,PV,QV,m,A,P,Q);
+}
+
+/* Optimal R-ate n-pairing r=e(P[0],Q[0])...e(P[n-1],Q[n-1]) */
+/* Pairs are taken PAIR_MULTI_MAX at a time, so the working memory does not depend on n. Up to PAIR_MULTI_SMALL pairs need less */
+void ZZZ::PAIR_ate_multi(FP48 *r,ECP8 *P,ECP *Q,int n)
+{
+	int j,m;
+	FP48 t;
+
+	m=n;
+	if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+	if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(r,P,Q,m);
+	else PAIR_multi_large(r,P,Q,m);
+	for (j=m; j<n; j+=m)
+	{
+		m=n-j;
+		if (m>PAIR_MULTI_MAX_ZZZ) m=PAIR_MULTI_MAX_ZZZ;
+		if (m<=PAIR_MULTI_SMALL) PAIR_multi_small(&t,&P[j],&Q[j],m);
+		else PAIR_multi_large(&t,&P[j],&Q[j],m);
+		FP48_mul(r,&t);
+	}
+}
+
 /* final exponentiation - keep separate for multi-pairings and to avoid thrashing stack */
 
 void ZZZ::PAIR_fexp(FP48 *r)
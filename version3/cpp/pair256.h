@@ -18,6 +18,8 @@ extern const XXX::BIG CURVE_SB[2][2]; /**< BN curve constant for GLV decompositi
 extern const XXX::BIG CURVE_WB[4];	 /**< BN curve constant for GS decomposition */
 extern const XXX::BIG CURVE_BB[4][4]; /**< BN curve constant for GS decomposition */
 
+#define PAIR_MULTI_MAX_ZZZ 4 /**< Number of pairings that share one pass of the Miller loop in PAIR_ate_multi */
+
 /* Pairing function prototypes */
 /**	@brief Calculate Miller loop for Optimal ATE pairing e(P,Q)
  *
@@ -37,6 +39,15 @@ extern void PAIR_ate(YYY::FP48 *r,ECP8 *P,ECP *Q);
 	@param S ECP instance, an element of G1
  */
 extern void PAIR_double_ate(YYY::FP48 *r,ECP8 *P,ECP *Q,ECP8 *R,ECP *S);
+/**	@brief Calculate Miller loop for Optimal ATE n-pairing e(P[0],Q[0]).e(P[1],Q[1])...e(P[n-1],Q[n-1])
+ *
+	One Miller loop is shared by up to PAIR_MULTI_MAX pairings. Unlike PAIR_initmp/PAIR_another/PAIR_miller no FP48 array is needed
+	@param r FP48 result of the n-pairing calculation
+	@param P ECP8 array of n elements of G2
+	@param Q ECP array of n elements of G1
+	@param n number of pairings
+ */
+extern void PAIR_ate_multi(YYY::FP48 *r,ECP8 *P,ECP *Q,int n);
 /**	@brief Final exponentiation of pairing, converts output of Miller loop to element in GT
  *
 	Here p is the internal modulus, and r is the group order
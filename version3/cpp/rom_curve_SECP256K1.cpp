@@ -24,6 +24,10 @@ const BIG CURVE_Order= {0x364141,0xD25E8CD,0x8A03BBF,0xDCE6AF4,0xFFEBAAE,0xFFFFF
 const BIG CURVE_Gx= {0x6F81798,0xF2815B1,0xE28D959,0xFCDB2DC,0xB07029B,0x95CE870,0xC55A062,0xF9DCBBA,0x9BE667E,0x7};
 const BIG CURVE_Gy= {0xB10D4B8,0x47D08FF,0x554199C,0xB448A68,0x8A8FD17,0xFC0E110,0x55DA4FB,0x26A3C46,0x83ADA77,0x4};
 
+const BIG CURVE_Cru= {0x19501EE,0x396C287,0x58995C1,0x497512F,0x4E99CF0,0x9EAC343,0x6E6447,0x657C071,0xAE96A2B,0x7};
+const BIG CURVE_W[2]= {{0x284EB15,0x6C90E49,0x46BCDE8,0xD221A7D,0x3086,0x0,0x0,0x0,0x0,0x0},{0xABFE4C3,0x547FA90,0xE88286F,0x7ED6010,0xE443,0x0,0x0,0x0,0x0,0x0}};
+const BIG CURVE_SB[2][2]= {{{0x284EB15,0x6C90E49,0x46BCDE8,0xD221A7D,0x3086,0x0,0x0,0x0,0x0,0x0},{0x5765C7E,0x7DDEE3C,0xA181350,0x5E10AE3,0xFFDD66B,0xFFFFFFF,0xFFFFFFF,0xFFFFFFF,0xFFFFFFF,0xF}},{{0xD44CFD8,0xC1108D9,0x2F3F657,0x50F7A8E,0x114CA,0x0,0x0,0x0,0x0,0x0},{0x284EB15,0x6C90E49,0x46BCDE8,0xD221A7D,0x3086,0x0,0x0,0x0,0x0,0x0}}};
+
 #endif
 
 #if CHUNK==64
@@ -40,6 +44,10 @@ const BIG CURVE_Order= {0xD25E8CD0364141L,0xDCE6AF48A03BBFL,0xFFFFFFFFFEBAAEL,0x
 const BIG CURVE_Gx= {0xF2815B16F81798L,0xFCDB2DCE28D959L,0x95CE870B07029BL,0xF9DCBBAC55A062L,0x79BE667EL};
 const BIG CURVE_Gy= {0x47D08FFB10D4B8L,0xB448A68554199CL,0xFC0E1108A8FD17L,0x26A3C4655DA4FBL,0x483ADA77L};
 
+const BIG CURVE_Cru= {0x396C28719501EEL,0x497512F58995C1L,0x9EAC3434E99CF0L,0x657C07106E6447L,0x7AE96A2BL};
+const BIG CURVE_W[2]= {{0x6C90E49284EB15L,0xD221A7D46BCDE8L,0x3086L,0x0L,0x0L},{0x547FA90ABFE4C3L,0x7ED6010E88286FL,0xE443L,0x0L,0x0L}};
+const BIG CURVE_SB[2][2]= {{{0x6C90E49284EB15L,0xD221A7D46BCDE8L,0x3086L,0x0L,0x0L},{0x7DDEE3C5765C7EL,0x5E10AE3A181350L,0xFFFFFFFFFDD66BL,0xFFFFFFFFFFFFFFL,0xFFFFFFFFL}},{{0xC1108D9D44CFD8L,0x50F7A8E2F3F657L,0x114CAL,0x0L,0x0L},{0x6C90E49284EB15L,0xD221A7D46BCDE8L,0x3086L,0x0L,0x0L}}};
+
 #endif
 
 }
@@ -38,6 +38,8 @@ under the License.
 #if CHUNK==32 || CHUNK==64
 #include "ecdh_NIST256.h"
 #include "ecdh_GOLDILOCKS.h"
+#include "ecdh_C25519.h"
+#include "ecdh_SECP256K1.h"
 #endif
 
 using namespace amcl;
@@ -513,6 +515,225 @@ int ecdh_GOLDILOCKS(csprng *RNG)
 
     return 0;
 }
+
+/* RFC 7748 section 5.2 test vectors for X25519 */
+int xdh_C25519()
+{
+    using namespace C25519;
+
+    int i;
+    char s[EGS_C25519],u[EFS_C25519],k[EFS_C25519],v[EFS_C25519];
+    octet S= {0,sizeof(s),s};
+    octet U= {0,sizeof(u),u};
+    octet K= {0,sizeof(k),k};
+    octet V= {0,sizeof(v),v};
+
+    OCT_fromHex(&S,(char *)"a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4");
+    OCT_fromHex(&U,(char *)"e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c");
+    OCT_fromHex(&V,(char *)"c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552");
+    if (ECP_XDH(&S,&U,&K)!=0 || !OCT_comp(&K,&V))
+    {
+        printf("*** X25519 Failed\n");
+        return 0;
+    }
+
+    OCT_fromHex(&S,(char *)"4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d");
+    OCT_fromHex(&U,(char *)"e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493");
+    OCT_fromHex(&V,(char *)"95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957");
+    if (ECP_XDH(&S,&U,&K)!=0 || !OCT_comp(&K,&V))
+    {
+        printf("*** X25519 Failed\n");
+        return 0;
+    }
+
+    // k=u=9, then repeatedly k,u=X25519(k,u),k
+    OCT_clear(&S);
+    OCT_jbyte(&S,9,1);
+    OCT_jbyte(&S,0,EGS_C25519-1);
+    OCT_copy(&U,&S);
+    for (i=1; i<=1000; i++)
+    {
+        ECP_XDH(&S,&U,&K);
+        OCT_copy(&U,&S);
+        OCT_copy(&S,&K);
+        if (i==1) OCT_fromHex(&V,(char *)"422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079");
+        if (i==1000) OCT_fromHex(&V,(char *)"684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51");
+        if ((i==1 || i==1000) && !OCT_comp(&K,&V))
+        {
+            printf("*** X25519 Failed after %d iterations\n",i);
+            return 0;
+        }
+    }
+
+    printf("X25519 test vectors succeeded\n");
+    return 0;
+}
+
+/* GLV multiplication on SECP256K1, against the comb and the multi-scalar method, which do not use the endomorphism */
+int glv_SECP256K1(csprng *RNG)
+{
+    using namespace SECP256K1;
+    using namespace SECP256K1_BIG;
+
+    int i;
+    BIG r,h,k[2];
+    ECP G,P,Q,R,W[2];
+    static ECP_precomp T;
+
+    BIG_rcopy(r,CURVE_Order);
+    ECP_generator(&G);
+    ECP_precomp_init(&T,&G);
+    for (i=0; i<10; i++)
+    {
+        if (i==0) BIG_zero(k[0]);
+        if (i==1)
+        {
+            BIG_copy(k[0],r);
+            BIG_dec(k[0],1);
+            BIG_norm(k[0]);
+        }
+        if (i>1) BIG_randomnum(k[0],r,RNG);
+        BIG_randomnum(k[1],r,RNG);
+
+        ECP_copy(&P,&G);
+        ECP_mul(&P,k[0]);
+        ECP_mul_gen(&Q,k[0]);
+        ECP_mul_precomp(&R,&T,k[0]);
+        if (!ECP_equals(&P,&Q) || !ECP_equals(&P,&R))
+        {
+            printf("*** GLV ECP_mul Failed\n");
+            return 0;
+        }
+        ECP_muln(&R,&G,k,1);
+        if (!ECP_equals(&P,&R))
+        {
+            printf("*** GLV ECP_mul Failed\n");
+            return 0;
+        }
+
+        BIG_randomnum(h,r,RNG);
+        ECP_copy(&W[0],&G);
+        ECP_mul_gen(&W[1],h);
+        ECP_copy(&P,&W[0]);
+        ECP_mul2(&P,&W[1],k[0],k[1]);
+        ECP_muln(&R,W,k,2);
+        if (!ECP_equals(&P,&R))
+        {
+            printf("*** GLV ECP_mul2 Failed\n");
+            return 0;
+        }
+    }
+
+    printf("GLV multiplication succeeded\n");
+    return 0;
+}
+
+/* Comb multiplication with precomputed tables, including after serialisation, against ECP_mul */
+int comb_NIST256(csprng *RNG)
+{
+    using namespace NIST256;
+    using namespace NIST256_BIG;
+
+    char pc[PRECOMP_BLOCKS_NIST256*((1<<PRECOMP_WINDOW_NIST256)-1)*(2*EFS_NIST256+1)];
+    octet PC= {0,sizeof(pc),pc};
+    static ECP_precomp T;
+    ECP P,Q;
+    BIG r,k;
+
+    BIG_rcopy(r,CURVE_Order);
+    BIG_randomnum(k,r,RNG);
+    ECP_generator(&P);
+    ECP_mul(&P,k);
+    BIG_randomnum(k,r,RNG);
+
+    ECP_precomp_init(&T,&P);
+    ECP_precomp_toOctet(&PC,&T);
+    ECP_copy(&Q,&P);
+    ECP_mul(&Q,k);
+    ECP_dbl(&P);
+    if (!ECP_precomp_fromOctet(&T,&PC))
+    {
+        printf("*** ECP_precomp_fromOctet Failed\n");
+        return 0;
+    }
+    ECP_mul_precomp(&P,&T,k);
+    if (!ECP_equals(&P,&Q))
+    {
+        printf("*** ECP_mul_precomp Failed\n");
+        return 0;
+    }
+    ECP_mul2_precomp(&P,&T,k,&T,k);
+    ECP_dbl(&Q);
+    if (!ECP_equals(&P,&Q))
+    {
+        printf("*** ECP_mul2_precomp Failed\n");
+        return 0;
+    }
+
+    // the comb tables of the point at infinity only give infinity
+    ECP_inf(&P);
+    ECP_precomp_init(&T,&P);
+    ECP_mul_precomp(&P,&T,k);
+    if (!ECP_isinf(&P))
+    {
+        printf("*** ECP_mul_precomp of infinity Failed\n");
+        return 0;
+    }
+
+    printf("Comb multiplication succeeded\n");
+    return 0;
+}
+
+/* Multi-scalar multiplication. 2 terms of k.P is 2k.P, 20 terms is 10 times that and 40 terms 20 times */
+int muln_NIST256(csprng *RNG)
+{
+    using namespace NIST256;
+    using namespace NIST256_BIG;
+
+    int i;
+    ECP MP[40],P,Q;
+    BIG MK[40],r,k,ten;
+
+    BIG_rcopy(r,CURVE_Order);
+    BIG_randomnum(k,r,RNG);
+    ECP_generator(&P);
+    ECP_mul(&P,k);
+    BIG_randomnum(k,r,RNG);
+    for (i=0; i<40; i++)
+    {
+        ECP_copy(&MP[i],&P);
+        BIG_copy(MK[i],k);
+    }
+    ECP_copy(&Q,&P);
+    ECP_mul(&Q,k);
+    ECP_dbl(&Q);
+
+    ECP_muln(&P,MP,MK,2);
+    if (!ECP_equals(&P,&Q))
+    {
+        printf("*** ECP_muln Failed\n");
+        return 0;
+    }
+    ECP_muln(&P,MP,MK,20);
+    BIG_zero(ten);
+    BIG_inc(ten,10);
+    ECP_mul(&Q,ten);
+    if (!ECP_equals(&P,&Q))
+    {
+        printf("*** ECP_muln Failed\n");
+        return 0;
+    }
+    ECP_muln_mt(&P,MP,MK,40,2);
+    ECP_dbl(&Q);
+    if (!ECP_equals(&P,&Q))
+    {
+        printf("*** ECP_muln_mt Failed\n");
+        return 0;
+    }
+
+    printf("Multi-scalar multiplication succeeded\n");
+    return 0;
+}
 #endif
 
 #define PERMITS  // for time permits ON or OFF 
@@ -1537,6 +1758,360 @@ int mpin256_BLS48(csprng *RNG)
 }
 #endif
 
+/* Cross-check fast BIG multiplication, squaring and Montgomery reduction against slow reference methods */
+/* Exercises whichever of the looped, unrolled, fused or MULX/ADX versions were selected at configuration time */
+
+int arith_BN254(csprng *RNG)
+{
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    int i,k;
+    BIG a,b,m,e,f;
+    DBIG c,d,t;
+    FP x,y,z;
+
+    BIG_rcopy(m,Modulus);
+    for (k=0; k<100; k++)
+    {
+        BIG_randomnum(a,m,RNG);
+        BIG_randomnum(b,m,RNG);
+
+        // reference product by shift and add
+        BIG_dzero(d);
+        BIG_dscopy(t,a);
+        for (i=BIG_nbits(b)-1; i>=0; i--)
+        {
+            BIG_dshl(d,1);
+            if (BIG_bit(b,i)) BIG_dadd(d,d,t);
+            BIG_dnorm(d);
+        }
+        BIG_mul(c,a,b);
+        if (BIG_dcomp(c,d)!=0)
+        {
+            printf("BIG_mul failed\n");
+            return 0;
+        }
+        BIG_sqr(c,a);
+        BIG_mul(d,a,a);
+        if (BIG_dcomp(c,d)!=0)
+        {
+            printf("BIG_sqr failed\n");
+            return 0;
+        }
+
+        // Montgomery/fused modular multiplication against slow division based method
+        FP_nres(&x,a);
+        FP_nres(&y,b);
+        FP_mul(&z,&x,&y);
+        FP_redc(e,&z);
+        BIG_mod(e,m);
+        BIG_modmul(f,a,b,m);
+        if (BIG_comp(e,f)!=0)
+        {
+            printf("FP_mul failed\n");
+            return 0;
+        }
+        FP_sqr(&z,&x);
+        FP_redc(e,&z);
+        BIG_mod(e,m);
+        BIG_modsqr(f,a,m);
+        if (BIG_comp(e,f)!=0)
+        {
+            printf("FP_sqr failed\n");
+            return 0;
+        }
+        FP_inv(&z,&x);
+        FP_mul(&z,&z,&x);
+        FP_one(&y);
+        if (!FP_equals(&z,&y))
+        {
+            printf("FP_inv failed\n");
+            return 0;
+        }
+    }
+
+    printf("Arithmetic cross-check succeeded\n");
+    return 1;
+}
+
+/* Batch inversion against one at a time, including a zero element */
+
+int invbatch_BN254(csprng *RNG)
+{
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    int k;
+    BIG a,b,m;
+    FP x,v[8],w[8];
+    FP2 x2,v2[8],w2[8];
+
+    BIG_rcopy(m,Modulus);
+    for (k=0; k<8; k++)
+    {
+        BIG_randomnum(a,m,RNG);
+        BIG_randomnum(b,m,RNG);
+        FP_nres(&v[k],a);
+        FP2_from_BIGs(&v2[k],a,b);
+    }
+    FP_zero(&v[3]);
+    FP2_zero(&v2[5]);
+    FP_inv_batch(w,v,8);
+    FP2_inv_batch(w2,v2,8);
+    for (k=0; k<8; k++)
+    {
+        FP_inv(&x,&v[k]);
+        FP2_inv(&x2,&v2[k]);
+        if (!FP_equals(&x,&w[k]) || !FP2_equals(&x2,&w2[k]))
+        {
+            printf("Batch inversion failed\n");
+            return 0;
+        }
+    }
+    printf("Batch inversion succeeded\n");
+    return 1;
+}
+
+/* Eight way multiplication against one at a time, with unreduced inputs */
+
+int mulx8_BN254(csprng *RNG)
+{
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    int k;
+    BIG a,b,m;
+    FP u[8],v[8],w[8];
+
+    BIG_rcopy(m,Modulus);
+    for (k=0; k<8; k++)
+    {
+        BIG_randomnum(a,m,RNG);
+        BIG_randomnum(b,m,RNG);
+        FP_nres(&v[k],a);
+        FP_nres(&w[k],b);
+        FP_add(&u[k],&v[k],&w[k]);
+        FP_mul(&w[k],&u[k],&v[k]);
+    }
+    FP_mul_x8(u,u,v);
+    for (k=0; k<8; k++)
+    {
+        if (!FP_equals(&u[k],&w[k]))
+        {
+            printf("FP_mul_x8 failed\n");
+            return 0;
+        }
+    }
+    printf("FP_mul_x8 succeeded\n");
+    return 1;
+}
+
+/* G2 comb tables, of a random point and of the point at infinity */
+
+int comb_BN254(csprng *RNG)
+{
+	using namespace BN254;
+	using namespace BN254_BIG;
+
+    static ECP2_precomp T;
+    ECP2 P,Q;
+    BIG a,m;
+
+    BIG_rcopy(m,CURVE_Order);
+    BIG_randomnum(a,m,RNG);
+    ECP2_generator(&P);
+    ECP2_copy(&Q,&P);
+    ECP2_mul(&Q,a);
+    ECP2_precomp_init(&T,&P);
+    ECP2_mul_precomp(&P,&T,a);
+    if (!ECP2_equals(&P,&Q))
+    {
+        printf("ECP2_mul_precomp failed\n");
+        return 0;
+    }
+    ECP2_inf(&P);
+    ECP2_precomp_init(&T,&P);
+    ECP2_mul_precomp(&P,&T,a);
+    if (!ECP2_isinf(&P))
+    {
+        printf("ECP2_mul_precomp of infinity failed\n");
+        return 0;
+    }
+    printf("ECP2 comb multiplication succeeded\n");
+    return 1;
+}
+
+/* Pairing with precomputed G2 lines against the direct method, including after serialisation */
+
+int pairprecomp_BN254(csprng *RNG)
+{
+	using namespace BN254;
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    static PAIR_precomp T,U;
+    static char pl[6*PFS_BN254*PAIR_PRECOMP_LINES_BN254];
+    octet PL= {0,sizeof(pl),pl};
+    ECP P;
+    ECP2 Q;
+    FP12 g,h,r[ATE_BITS_BN254];
+    BIG a,m;
+
+    BIG_rcopy(m,CURVE_Order);
+    BIG_randomnum(a,m,RNG);
+    ECP_generator(&P);
+    PAIR_G1mul(&P,a);
+    BIG_randomnum(a,m,RNG);
+    ECP2_generator(&Q);
+    PAIR_G2mul(&Q,a);
+
+    PAIR_ate(&g,&Q,&P);
+    PAIR_precomp_init(&T,&Q);
+    PAIR_ate_precomp(&h,&T,&P);
+    PAIR_precomp_toOctet(&PL,&T);
+    if (!FP12_equals(&g,&h) || !PAIR_precomp_fromOctet(&U,&PL))
+    {
+        printf("PAIR_ate_precomp failed\n");
+        return 0;
+    }
+    PAIR_initmp(r);
+    PAIR_another_precomp(r,&U,&P);
+    PAIR_miller(&h,r);
+    if (!FP12_equals(&g,&h))
+    {
+        printf("PAIR_another_precomp failed\n");
+        return 0;
+    }
+    printf("Pairing with precomputed lines succeeded\n");
+    return 1;
+}
+
+/* Shared Miller loop against separate pairings, with a precomputed pairing and over more than one pass */
+
+int pairmulti_BN254(csprng *RNG)
+{
+	using namespace BN254;
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    int k;
+    static PAIR_precomp T;
+    ECP P,QA[PAIR_MULTI_MAX_BN254+3];
+    ECP2 Q,PA[PAIR_MULTI_MAX_BN254+3];
+    FP12 g,h;
+    BIG a,m;
+
+    BIG_rcopy(m,CURVE_Order);
+    BIG_randomnum(a,m,RNG);
+    ECP_generator(&P);
+    PAIR_G1mul(&P,a);
+    BIG_randomnum(a,m,RNG);
+    ECP2_generator(&Q);
+    PAIR_G2mul(&Q,a);
+
+    PAIR_ate(&g,&Q,&P);
+    PAIR_precomp_init(&T,&Q);
+    for (k=0; k<PAIR_MULTI_MAX_BN254+3; k++)
+    {
+        ECP2_copy(&PA[k],&Q);
+        ECP_copy(&QA[k],&P);
+        if (k>0)
+        {
+            ECP2_add(&PA[k],&PA[k-1]);
+            ECP_add(&QA[k],&QA[k-1]);
+        }
+        PAIR_ate(&h,&PA[k],&QA[k]);
+        FP12_mul(&g,&h);
+    }
+    PAIR_ate_multi_precomp(&h,&T,&P,PA,QA,PAIR_MULTI_MAX_BN254+3);
+    if (!FP12_equals(&g,&h))
+    {
+        printf("PAIR_ate_multi failed\n");
+        return 0;
+    }
+
+    // two pairings, which take the small path
+    PAIR_ate(&g,&PA[0],&QA[0]);
+    PAIR_ate(&h,&PA[1],&QA[1]);
+    FP12_mul(&g,&h);
+    PAIR_ate_multi(&h,PA,QA,2);
+    if (!FP12_equals(&g,&h))
+    {
+        printf("PAIR_ate_multi failed\n");
+        return 0;
+    }
+    printf("Multi-pairing succeeded\n");
+    return 1;
+}
+
+/* Exponentiation in GT with compressed squarings against the plain method */
+
+int upow_BN254(csprng *RNG)
+{
+	using namespace BN254;
+	using namespace BN254_BIG;
+	using namespace BN254_FP;
+
+    ECP P;
+    ECP2 Q;
+    FP12 g,h;
+    BIG a,m;
+
+    BIG_rcopy(m,CURVE_Order);
+    BIG_randomnum(a,m,RNG);
+    ECP_generator(&P);
+    ECP2_generator(&Q);
+    PAIR_ate(&g,&Q,&P);
+    PAIR_fexp(&g);
+    FP12_pow(&h,&g,a);
+    FP12_upow(&g,&g,a);
+    if (!FP12_equals(&g,&h))
+    {
+        printf("FP12_upow failed\n");
+        return 0;
+    }
+    printf("FP12_upow succeeded\n");
+    return 1;
+}
+
+#if CHUNK==32 || CHUNK==64
+/* Exponentiation in GT with compressed squarings against the plain method, by a random exponent and by the curve parameter of the final exponentiation */
+
+int upow_BLS24(csprng *RNG)
+{
+	using namespace BLS24;
+	using namespace BLS24_BIG;
+	using namespace BLS24_FP;
+
+    int k;
+    ECP P;
+    ECP4 Q;
+    FP24 g,h,t;
+    BIG a,m;
+
+    BIG_rcopy(m,CURVE_Order);
+    ECP_generator(&P);
+    ECP4_generator(&Q);
+    PAIR_ate(&g,&Q,&P);
+    PAIR_fexp(&g);
+    for (k=0; k<2; k++)
+    {
+        if (k==0) BIG_randomnum(a,m,RNG);
+        else BIG_rcopy(a,CURVE_Bnx);
+        FP24_pow(&h,&g,a);
+        FP24_upow(&t,&g,a);
+        if (!FP24_equals(&t,&h))
+        {
+            printf("FP24_upow failed\n");
+            return 0;
+        }
+    }
+    printf("FP24_upow succeeded\n");
+    return 1;
+}
+#endif
+
 int rsa_2048(csprng *RNG)
 {
 	using namespace RSA2048;
@@ -1616,6 +2191,25 @@ int main()
 
     CREATE_CSPRNG(&RNG,&RAW);   // initialise strong RNG 
 
+	printf("\nTesting arithmetic for curve BN254\n");
+	arith_BN254(&RNG);
+	printf("\nTesting batch inversion for curve BN254\n");
+	invbatch_BN254(&RNG);
+	printf("\nTesting eight way multiplication for curve BN254\n");
+	mulx8_BN254(&RNG);
+	printf("\nTesting G2 comb multiplication for curve BN254\n");
+	comb_BN254(&RNG);
+	printf("\nTesting pairing with precomputed lines for curve BN254\n");
+	pairprecomp_BN254(&RNG);
+	printf("\nTesting multi-pairing for curve BN254\n");
+	pairmulti_BN254(&RNG);
+	printf("\nTesting GT exponentiation for curve BN254\n");
+	upow_BN254(&RNG);
+#if CHUNK!=16
+	printf("\nTesting GT exponentiation for curve BLS24\n");
+	upow_BLS24(&RNG);
+#endif
+
 	printf("\nTesting MPIN protocols for curve BN254\n");
 	mpin_BN254(&RNG);
 
@@ -1635,6 +2229,14 @@ int main()
 	ecdh_NIST256(&RNG);
 	printf("\nTesting ECDH protocols for curve GOLDILOCKS\n");
 	ecdh_GOLDILOCKS(&RNG);
+	printf("\nTesting X25519 for curve C25519\n");
+	xdh_C25519();
+	printf("\nTesting GLV multiplication for curve SECP256K1\n");
+	glv_SECP256K1(&RNG);
+	printf("\nTesting comb multiplication for curve NIST256\n");
+	comb_NIST256(&RNG);
+	printf("\nTesting multi-scalar multiplication for curve NIST256\n");
+	muln_NIST256(&RNG);
 #endif
 	printf("\nTesting RSA protocols for 2048-bit RSA\n");
 	rsa_2048(&RNG);
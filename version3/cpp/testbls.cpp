@@ -63,6 +63,97 @@ int bls_BN254(csprng *RNG)
 	res=BLS_VERIFY(&SIG,message,&W);
 	if (res==BLS_OK) printf("Signature is OK\n");
 	else printf("Signature is *NOT* OK\n");
+
+	// batch of signatures under different keys, then with one message changed
+	int i,b,bres[5];
+	char bs[5][BGS_BN254],bsig[5][BFS_BN254+1],bw[5][4*BFS_BN254],bm[5][30];
+	char as[BFS_BN254+1],aw[4*BFS_BN254];
+	char *BM[5];
+	octet BS[5],BSIG[5],BW[5];
+	octet AS= {0,sizeof(as),as};
+	octet AW= {0,sizeof(aw),aw};
+	for (i=0; i<5; i++)
+	{
+		BS[i].len=0; BS[i].max=sizeof(bs[i]); BS[i].val=bs[i];
+		BSIG[i].len=0; BSIG[i].max=sizeof(bsig[i]); BSIG[i].val=bsig[i];
+		BW[i].len=0; BW[i].max=sizeof(bw[i]); BW[i].val=bw[i];
+		sprintf(bm[i],"Batch message %d",i);
+		BM[i]=bm[i];
+		BLS_KEY_PAIR_GENERATE(RNG,&BS[i],&BW[i]);
+		BLS_SIGN(&BSIG[i],BM[i],&BS[i]);
+	}
+	b=BLS_VERIFY_BATCH(RNG,bres,BSIG,BM,BW,5);
+	if (b==BLS_OK) printf("Signature batch is OK\n");
+	else printf("Signature batch is *NOT* OK\n");
+
+	BLS_AGGREGATE_SIG(&AS,BSIG,5);
+	b=BLS_AGGREGATE_VERIFY(&AS,BM,BW,5);
+	if (b==BLS_OK) printf("Aggregate signature is OK\n");
+	else printf("Aggregate signature is *NOT* OK\n");
+
+	bm[3][0]='b';
+	b=BLS_VERIFY_BATCH(RNG,bres,BSIG,BM,BW,5);
+	for (i=0; i<5; i++)
+		if (bres[i]!=(i==3?BLS_FAIL:BLS_OK)) break;
+	if (b==BLS_FAIL && i==5) printf("Bad signature in batch found\n");
+	else printf("Bad signature in batch *NOT* found\n");
+
+	// a signature and public key which do not decode fail, rather than dropping out of the product
+	char ks[BFS_BN254+1],kw[4*BFS_BN254];
+	octet KS= {0,sizeof(ks),ks};
+	octet KW= {0,sizeof(kw),kw};
+	OCT_copy(&KS,&BSIG[1]);
+	OCT_copy(&KW,&BW[1]);
+	for (i=0; i<BSIG[1].len; i++) bsig[1][i]=(char)0xff;
+	for (i=0; i<BW[1].len; i++) bw[1][i]=(char)0xff;
+	b=BLS_VERIFY_BATCH(RNG,bres,BSIG,BM,BW,5);
+	OCT_copy(&BSIG[1],&KS);
+	OCT_copy(&BW[1],&KW);
+	for (i=0; i<5; i++)
+		if (bres[i]!=((i==1 || i==3)?BLS_FAIL:BLS_OK)) break;
+	if (b==BLS_FAIL && i==5) printf("Bad public key in batch found\n");
+	else printf("Bad public key in batch *NOT* found\n");
+
+	// a signature of BM[0] alone must not pass as an aggregate with a key that does not decode, nor with a repeated message
+	int c;
+	for (i=0; i<BW[1].len; i++) bw[1][i]=(char)0xff;
+	b=BLS_AGGREGATE_VERIFY(&BSIG[0],BM,BW,2);
+	OCT_copy(&BW[1],&KW);
+	BLS_SIGN(&BSIG[1],BM[0],&BS[1]);
+	BLS_AGGREGATE_SIG(&AS,BSIG,2);
+	BM[1]=BM[0];
+	c=BLS_AGGREGATE_VERIFY(&AS,BM,BW,2);
+	BM[1]=bm[1];
+	if (b==BLS_FAIL && c==BLS_FAIL) printf("Bad aggregate signatures rejected\n");
+	else printf("Bad aggregate signatures *NOT* rejected\n");
+
+	// more than 16 messages are sorted to find a repeat, and each key must stay with its message
+	char lm[20][30],lsig[20][BFS_BN254+1];
+	char *LM[20];
+	octet LSIG[20],LW[20];
+	for (c=0; c<2; c++)
+	{
+		for (i=0; i<20; i++)
+		{
+			sprintf(lm[i],"Long batch message %d",(c==1 && i==17)?3:19-i);
+			LM[i]=lm[i];
+			LW[i]=BW[i%5];
+			LSIG[i].len=0; LSIG[i].max=sizeof(lsig[i]); LSIG[i].val=lsig[i];
+			BLS_SIGN(&LSIG[i],LM[i],&BS[i%5]);
+		}
+		BLS_AGGREGATE_SIG(&AS,LSIG,20);
+		bres[c]=BLS_AGGREGATE_VERIFY(&AS,LM,LW,20);
+	}
+	if (bres[0]==BLS_OK && bres[1]==BLS_FAIL) printf("Long aggregate signature is OK\n");
+	else printf("Long aggregate signature is *NOT* OK\n");
+
+	// aggregate of signatures of one message
+	for (i=0; i<5; i++)
+		BLS_SIGN(&BSIG[i],message,&BS[i]);
+	BLS_AGGREGATE_SIG(&AS,BSIG,5);
+	BLS_AGGREGATE_PK(&AW,BW,5);
+	if (BLS_FAST_AGGREGATE_VERIFY(&AS,message,BW,5)==BLS_OK && BLS_VERIFY(&AS,message,&AW)==BLS_OK) printf("Aggregate signature of one message is OK\n");
+	else printf("Aggregate signature of one message is *NOT* OK\n");
 	return res;
 }
 
@@ -123,6 +214,34 @@ int bls_BLS24(csprng *RNG)
 	res=BLS_VERIFY(&SIG,message,&W);
 	if (res==BLS_OK) printf("Signature is OK\n");
 	else printf("Signature is *NOT* OK\n");
+
+	// aggregate signatures of distinct messages, and of one message
+	int i,b;
+	char bs[3][BGS_BLS24],bsig[3][BFS_BLS24+1],bw[3][8*BFS_BLS24],bm[3][30],as[BFS_BLS24+1];
+	char *BM[3];
+	octet BS[3],BSIG[3],BW[3];
+	octet AS= {0,sizeof(as),as};
+	for (i=0; i<3; i++)
+	{
+		BS[i].len=0; BS[i].max=sizeof(bs[i]); BS[i].val=bs[i];
+		BSIG[i].len=0; BSIG[i].max=sizeof(bsig[i]); BSIG[i].val=bsig[i];
+		BW[i].len=0; BW[i].max=sizeof(bw[i]); BW[i].val=bw[i];
+		sprintf(bm[i],"Aggregate message %d",i);
+		BM[i]=bm[i];
+		BLS_KEY_PAIR_GENERATE(RNG,&BS[i],&BW[i]);
+		BLS_SIGN(&BSIG[i],BM[i],&BS[i]);
+	}
+	BLS_AGGREGATE_SIG(&AS,BSIG,3);
+	b=BLS_AGGREGATE_VERIFY(&AS,BM,BW,3);
+	if (b==BLS_OK) printf("Aggregate signature is OK\n");
+	else printf("Aggregate signature is *NOT* OK\n");
+
+	for (i=0; i<3; i++)
+		BLS_SIGN(&BSIG[i],message,&BS[i]);
+	BLS_AGGREGATE_SIG(&AS,BSIG,3);
+	b=BLS_FAST_AGGREGATE_VERIFY(&AS,message,BW,3);
+	if (b==BLS_OK) printf("Aggregate signature of one message is OK\n");
+	else printf("Aggregate signature of one message is *NOT* OK\n");
 	return res;
 }
 
@@ -152,6 +271,34 @@ int bls_BLS48(csprng *RNG)
 	res=BLS_VERIFY(&SIG,message,&W);
 	if (res==BLS_OK) printf("Signature is OK\n");
 	else printf("Signature is *NOT* OK\n");
+
+	// aggregate signatures of distinct messages, and of one message
+	int i,b;
+	char bs[3][BGS_BLS48],bsig[3][BFS_BLS48+1],bw[3][16*BFS_BLS48],bm[3][30],as[BFS_BLS48+1];
+	char *BM[3];
+	octet BS[3],BSIG[3],BW[3];
+	octet AS= {0,sizeof(as),as};
+	for (i=0; i<3; i++)
+	{
+		BS[i].len=0; BS[i].max=sizeof(bs[i]); BS[i].val=bs[i];
+		BSIG[i].len=0; BSIG[i].max=sizeof(bsig[i]); BSIG[i].val=bsig[i];
+		BW[i].len=0; BW[i].max=sizeof(bw[i]); BW[i].val=bw[i];
+		sprintf(bm[i],"Aggregate message %d",i);
+		BM[i]=bm[i];
+		BLS_KEY_PAIR_GENERATE(RNG,&BS[i],&BW[i]);
+		BLS_SIGN(&BSIG[i],BM[i],&BS[i]);
+	}
+	BLS_AGGREGATE_SIG(&AS,BSIG,3);
+	b=BLS_AGGREGATE_VERIFY(&AS,BM,BW,3);
+	if (b==BLS_OK) printf("Aggregate signature is OK\n");
+	else printf("Aggregate signature is *NOT* OK\n");
+
+	for (i=0; i<3; i++)
+		BLS_SIGN(&BSIG[i],message,&BS[i]);
+	BLS_AGGREGATE_SIG(&AS,BSIG,3);
+	b=BLS_FAST_AGGREGATE_VERIFY(&AS,message,BW,3);
+	if (b==BLS_OK) printf("Aggregate signature of one message is OK\n");
+	else printf("Aggregate signature of one message is *NOT* OK\n");
 	return res;
 }
 